@@ -0,0 +1,11 @@
+#version 450 core
+
+layout (binding  = 0) uniform sampler2D cacheSampler;
+
+layout (location = 0) out vec4 outColor;
+
+void main(void)
+{
+    // NOTE Cache has the same extent as the framebuffer
+    outColor = texelFetch(cacheSampler, ivec2(gl_FragCoord.xy), 0);
+}
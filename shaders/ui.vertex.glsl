@@ -4,6 +4,9 @@ layout (location = 0) in vec2 inPos;
 layout (location = 1) in vec2 inUV;
 layout (location = 2) in vec4 inColor;
 
+// e.g. decode fixed point positions from normalized attributes
+layout (constant_id = 0) const float kPositionScale = 1.0;
+
 layout (push_constant) uniform PushConstants {
     vec2 scale;
     vec2 translate;
@@ -21,5 +24,5 @@ void main(void)
 {
     outUV = inUV;
     outColor = inColor;
-    gl_Position = vec4(inPos * pushConstants.scale + pushConstants.translate, 0.0, 1.0);
+    gl_Position = vec4(inPos * kPositionScale * pushConstants.scale + pushConstants.translate, 0.0, 1.0);
 }
@@ -0,0 +1,46 @@
+#version 450 core
+
+layout (binding  = 0) uniform sampler2D sceneSampler;
+
+layout (push_constant) uniform PushConstants {
+    // Framebuffer pixel to scene texel
+    vec2  scale;
+    // Rendered region of the scene image, in texels
+    vec2  extent;
+    // Reciprocal of the scene image extent
+    vec2  texel;
+    // 0 for a plain bilinear upscale
+    float sharpness;
+} pushConstants;
+
+layout (location = 0) out vec4 outColor;
+
+vec4 fetch(vec2 position)
+{
+    // NOTE Scene image may be larger than the rendered region, bilinear taps must not reach beyond it
+    position = clamp(position, vec2(0.5), pushConstants.extent - vec2(0.5));
+    return textureLod(sceneSampler, position * pushConstants.texel, 0.0);
+}
+
+void main(void)
+{
+    const vec2 position = gl_FragCoord.xy * pushConstants.scale;
+    const vec4 center   = fetch(position);
+    if (pushConstants.sharpness <= 0.0)
+    {
+        outColor = center;
+        return;
+    }
+
+    // Unsharp mask over the 4 neighbours, clamped to their range to avoid ringing
+    const vec4 north = fetch(position + vec2( 0.0, -1.0));
+    const vec4 south = fetch(position + vec2( 0.0, +1.0));
+    const vec4 west  = fetch(position + vec2(-1.0,  0.0));
+    const vec4 east  = fetch(position + vec2(+1.0,  0.0));
+
+    const vec4 average = (north + south + west + east) * 0.25;
+    const vec4 lowest  = min(center, min(min(north, south), min(west, east)));
+    const vec4 highest = max(center, max(max(north, south), max(west, east)));
+
+    outColor = clamp(center + pushConstants.sharpness * (center - average), lowest, highest);
+}
@@ -0,0 +1,610 @@
+#include <vulkan/vulkan.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cassert>
+#include <cinttypes>
+
+#include <span>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <limits>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+#include <imgui.h>
+#include <json.hpp>
+#include <utilities.hpp>
+
+#include "../vkdebug.hpp"
+#include "../vkdebugutils.hpp"
+#include "../vkutilities.hpp"
+
+#include "../vkqueue.hpp"
+#include "../vkimage.hpp"
+#include "../vkmemory.hpp"
+#include "../vkengine.hpp"
+#include "../vkapplication.hpp"
+#include "../vkphysicaldevice.hpp"
+#include "../vkprofiler.hpp"
+#include "../vkperformancewarnings.hpp"
+#include "../vkmemorytracer.hpp"
+
+#include "../sample0/vksample0.hpp"
+#include "../sample0/uidrawcapture.hpp"
+
+// Render frames offscreen through Engine and Sample with scripted UI and scene state, then report per scenario
+//  CPU record and submit times, and GPU frame times, as JSON (mean, p50, p95, p99 in milliseconds)
+//  Pipeline statistics are reported per pass, as means per frame, when the device supports them
+//  Usage: vkplaygrounds-bench [--frames=<count>] [--warmup=<count>] [--width=<pixels>] [--height=<pixels>]
+//                             [--scenario=<name>] [--device=<index>] [--validation] [--best-practices] [--trace=<path>] [--replay=<path>]
+//  NOTE --best-practices implies --validation, messages are reported under "performance_warnings"
+//  NOTE --trace exports the CPU zones as a Chrome trace, when built with ENABLE_PROFILING
+//  NOTE --replay enables the replay scenarios, which feed a UI draw data capture (see DrawDataRecorder) instead of ImGui frames
+//   Upload is then timed on its own, and the resolution defaults to the captured one
+//  NOTE Any Vulkan 1.2 device with a graphics queue is accepted, e.g. lavapipe on a headless machine
+
+namespace
+{
+    constexpr std::size_t       kDefaultFrames       = 500;
+    constexpr std::size_t       kDefaultWarmupFrames = 50;
+    constexpr VkExtent2D        kDefaultResolution   = { 1280, 720 };
+    // NOTE Mimics a double-buffered swapchain
+    constexpr std::uint32_t     kBackBufferCount     = 2;
+    constexpr VkFormat          kBackBufferFormat    = VK_FORMAT_B8G8R8A8_UNORM;
+    constexpr VkImageUsageFlags kBackBufferUsage     = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+    using clock_t    = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double, std::milli>;
+
+    using ui_t    = decltype(blk::sample0::PassUIOverlay::mUI);
+    using mouse_t = decltype(blk::sample0::PassUIOverlay::mMouse);
+
+    // UI and scene state applied before each frame
+    struct Scenario
+    {
+        const char* name;
+        std::function<void(std::size_t frame, const VkExtent2D& resolution, ui_t& ui, mouse_t& mouse)> script;
+        // Draw data comes from the capture, see --replay
+        bool        replay = false;
+    };
+
+    // Mouse sweeping over the whole window, enough for hovering to change the UI every frame
+    void sweep_mouse(std::size_t frame, const VkExtent2D& resolution, mouse_t& mouse)
+    {
+        const float t = static_cast<float>(frame) * 0.05f;
+        mouse.offset.x = 0.5f * resolution.width  * (1.0f + std::sin(t));
+        mouse.offset.y = 0.5f * resolution.height * (1.0f + std::sin(1.7f * t));
+    }
+
+    const std::array kScenarios{
+        // Nothing changes, draw data is re-used as when rendering on demand
+        Scenario{
+            .name   = "idle",
+            .script = [](std::size_t, const VkExtent2D&, ui_t& ui, mouse_t&) {
+                ui.show_gpu_information = false;
+                ui.show_demo            = false;
+                ui.packed_vertices      = false;
+                ui.cache_ui             = false;
+                ui.dynamic_resolution   = false;
+            },
+        },
+        Scenario{
+            .name   = "ui",
+            .script = [](std::size_t frame, const VkExtent2D& resolution, ui_t& ui, mouse_t& mouse) {
+                ui.show_gpu_information = true;
+                ui.show_demo            = true;
+                ui.packed_vertices      = false;
+                ui.cache_ui             = false;
+                ui.dynamic_resolution   = false;
+                sweep_mouse(frame, resolution, mouse);
+            },
+        },
+        Scenario{
+            .name   = "ui-packed-cached",
+            .script = [](std::size_t frame, const VkExtent2D& resolution, ui_t& ui, mouse_t& mouse) {
+                ui.show_gpu_information = true;
+                ui.show_demo            = true;
+                ui.packed_vertices      = true;
+                ui.cache_ui             = true;
+                ui.dynamic_resolution   = false;
+                sweep_mouse(frame, resolution, mouse);
+            },
+        },
+        // NOTE Target is unreachable on purpose, the scene is rendered at the minimum scale once converged
+        Scenario{
+            .name   = "dynamic-resolution",
+            .script = [](std::size_t frame, const VkExtent2D& resolution, ui_t& ui, mouse_t& mouse) {
+                ui.show_gpu_information = true;
+                ui.show_demo            = false;
+                ui.packed_vertices      = true;
+                ui.cache_ui             = true;
+                ui.dynamic_resolution   = true;
+                ui.target_gpu_time      = 0.01f;
+                ui.upscale_sharpness    = 0.5f;
+                sweep_mouse(frame, resolution, mouse);
+            },
+        },
+        // NOTE Only run with a capture, ImGui frames are not rendered
+        Scenario{
+            .name   = "replay",
+            .script = [](std::size_t, const VkExtent2D&, ui_t& ui, mouse_t&) {
+                ui.packed_vertices      = false;
+                ui.cache_ui             = false;
+                ui.dynamic_resolution   = false;
+            },
+            .replay = true,
+        },
+        Scenario{
+            .name   = "replay-packed",
+            .script = [](std::size_t, const VkExtent2D&, ui_t& ui, mouse_t&) {
+                ui.packed_vertices      = true;
+                ui.cache_ui             = false;
+                ui.dynamic_resolution   = false;
+            },
+            .replay = true,
+        },
+    };
+
+    struct Samples
+    {
+        std::vector<double> record;
+        // Replay only, optimize and upload of the draw data, also part of record
+        std::vector<double> upload;
+        std::vector<double> submit;
+        std::vector<double> gpu;
+        // Sums over pipeline_frames, per pass, see Sample::kPipelineStatisticsPasses
+        std::array<blk::PipelineStatistics, blk::sample0::Sample::kPipelineStatisticsPasses.size()> pipeline = {};
+        std::size_t         pipeline_frames = 0;
+    };
+
+    struct Statistics
+    {
+        double mean;
+        double p50;
+        double p95;
+        double p99;
+    };
+
+    std::optional<Statistics> statistics(std::vector<double> samples)
+    {
+        if (samples.empty())
+            return std::nullopt;
+
+        std::ranges::sort(samples);
+        // Nearest-rank percentile
+        auto percentile = [&samples](double p) {
+            const auto rank = static_cast<std::size_t>(std::ceil(p * samples.size()));
+            return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1];
+        };
+
+        double sum = 0.0;
+        for (auto&& sample : samples)
+            sum += sample;
+
+        return Statistics{
+            .mean = sum / samples.size(),
+            .p50  = percentile(0.50),
+            .p95  = percentile(0.95),
+            .p99  = percentile(0.99),
+        };
+    }
+
+    void report(std::ostream& stream, const char* name, const std::optional<Statistics>& statistics, bool last)
+    {
+        stream << "      " << json_string(name) << ": ";
+        if (statistics)
+            stream << "{ \"mean\": " << statistics->mean
+                   << ", \"p50\": "  << statistics->p50
+                   << ", \"p95\": "  << statistics->p95
+                   << ", \"p99\": "  << statistics->p99
+                   << " }";
+        else
+            stream << "null";
+        stream << (last ? "" : ",") << '\n';
+    }
+
+    void report_pipeline_statistics(std::ostream& stream, const Samples& samples)
+    {
+        stream << "      \"pipeline_statistics\": ";
+        if (samples.pipeline_frames == 0)
+        {
+            stream << "null\n";
+            return;
+        }
+
+        const double frames = static_cast<double>(samples.pipeline_frames);
+        stream << "{\n";
+        for (std::size_t index = 0; index < samples.pipeline.size(); ++index)
+        {
+            const blk::PipelineStatistics& sums = samples.pipeline[index];
+            stream << "        " << json_string(blk::sample0::Sample::kPipelineStatisticsPasses[index]) << ": "
+                   << "{ \"ia_vertices\": "     << sums.input_assembly_vertices / frames
+                   << ", \"ia_primitives\": "   << sums.input_assembly_primitives / frames
+                   << ", \"vs_invocations\": "  << sums.vertex_shader_invocations / frames
+                   << ", \"clip_primitives\": " << sums.clipping_primitives / frames
+                   << ", \"fs_invocations\": "  << sums.fragment_shader_invocations / frames
+                   << " }" << ((index + 1 < samples.pipeline.size()) ? "," : "") << '\n';
+        }
+        stream << "      }\n";
+    }
+
+    void report_performance_warnings(std::ostream& stream)
+    {
+        const auto warnings = blk::PerformanceWarnings::instance().warnings();
+        stream << "  \"performance_warnings\": [";
+        for (std::size_t index = 0; index < warnings.size(); ++index)
+        {
+            const auto& warning = warnings[index];
+            stream << ((index == 0) ? "\n" : ",\n")
+                   << "    { \"id\": "    << warning.id
+                   << ", \"name\": "      << json_string(warning.name)
+                   << ", \"count\": "     << warning.count
+                   << " }";
+        }
+        stream << (warnings.empty() ? "]\n" : "\n  ]\n");
+    }
+
+    std::optional<std::size_t> parse_count(std::string_view arg, std::string_view option)
+    {
+        if (!arg.starts_with(option))
+            return std::nullopt;
+
+        return std::strtoull(std::string(arg.substr(option.size())).c_str(), nullptr, 10);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t frames        = kDefaultFrames;
+    std::size_t warmup        = kDefaultWarmupFrames;
+    VkExtent2D  resolution    = kDefaultResolution;
+    bool        validation    = false;
+    bool        best_practices = false;
+    std::optional<std::size_t> device_index;
+    std::vector<std::string_view> scenarios;
+    std::optional<std::string_view> trace_path;
+    std::optional<std::string_view> replay_path;
+    bool        explicit_resolution = false;
+    {// Command line
+        for (int idx = 1; idx < argc; ++idx)
+        {
+            const std::string_view arg(argv[idx]);
+            if (auto count = parse_count(arg, "--frames="))
+                frames = std::max<std::size_t>(*count, 1);
+            else if (auto count = parse_count(arg, "--warmup="))
+                warmup = *count;
+            else if (auto count = parse_count(arg, "--width="))
+            {
+                resolution.width    = static_cast<std::uint32_t>(std::max<std::size_t>(*count, 1));
+                explicit_resolution = true;
+            }
+            else if (auto count = parse_count(arg, "--height="))
+            {
+                resolution.height   = static_cast<std::uint32_t>(std::max<std::size_t>(*count, 1));
+                explicit_resolution = true;
+            }
+            else if (auto count = parse_count(arg, "--device="))
+                device_index = *count;
+            else if (arg.starts_with("--scenario="))
+                scenarios.push_back(arg.substr(std::string_view("--scenario=").size()));
+            else if (arg.starts_with("--trace="))
+                trace_path = arg.substr(std::string_view("--trace=").size());
+            else if (arg.starts_with("--replay="))
+                replay_path = arg.substr(std::string_view("--replay=").size());
+            else if (arg == "--validation")
+                validation = true;
+            else if (arg == "--best-practices")
+                validation = best_practices = true;
+            else
+            {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    std::unique_ptr<blk::sample0::DrawDataReplay> replay;
+    if (replay_path)
+    {
+        replay = std::make_unique<blk::sample0::DrawDataReplay>(std::string(*replay_path));
+        if (!replay->valid())
+        {
+            std::cerr << "Invalid capture: " << *replay_path << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (!explicit_resolution)
+        {
+            const ImDrawData& data = replay->decode(0, {});
+            resolution.width  = static_cast<std::uint32_t>(std::max(data.DisplaySize.x * data.FramebufferScale.x, 1.0f));
+            resolution.height = static_cast<std::uint32_t>(std::max(data.DisplaySize.y * data.FramebufferScale.y, 1.0f));
+        }
+    }
+
+    BLK_PROFILE_THREAD("Main");
+
+    std::uint32_t apiVersion;
+    CHECK(vkEnumerateInstanceVersion(&apiVersion));
+    if (apiVersion < VK_MAKE_VERSION(1,2,0))
+    {
+        std::cerr << "Vulkan 1.2 is required" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // NOTE Validation noticeably skews timings, it is only meant to check the benchmark itself
+    VulkanApplication application(Version{ VK_MAKE_VERSION(1, 2, 0) }, validation, best_practices);
+
+    auto vkphysicaldevices = blk::physicaldevices(application);
+
+    auto isSuitable = [](const blk::PhysicalDevice& vkphysicaldevice) {
+        // Engine requirements:
+        //  - GRAPHICS queue
+        if (vkphysicaldevice.mProperties.apiVersion < VK_MAKE_VERSION(1,2,0))
+            return false;
+
+        return std::ranges::any_of(
+            vkphysicaldevice.mQueueFamilies,
+            [](const blk::QueueFamily& family) {
+                return family.supports_presentation();
+            }
+        );
+    };
+
+    const blk::PhysicalDevice* selected = nullptr;
+    if (device_index)
+    {
+        if ((*device_index < vkphysicaldevices.size()) && isSuitable(vkphysicaldevices.at(*device_index)))
+            selected = &(vkphysicaldevices.at(*device_index));
+    }
+    else
+    {// Discrete GPU first, anything else otherwise (e.g. software rasterizer)
+        for (auto&& vkphysicaldevice : vkphysicaldevices)
+        {
+            if (!isSuitable(vkphysicaldevice))
+                continue;
+
+            if (!selected || (vkphysicaldevice.mProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU))
+                selected = &vkphysicaldevice;
+            if (selected->mProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+                break;
+        }
+    }
+    if (!selected)
+    {
+        std::cerr << "No suitable GPU" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const blk::PhysicalDevice& vkphysicaldevice(*selected);
+    std::cerr << "Selected GPU: " << vkphysicaldevice.mProperties.deviceName << " (" << DeviceType2Text(vkphysicaldevice.mProperties.deviceType) << ')' << std::endl;
+
+    blk::Engine engine = [&application, &vkphysicaldevice]{
+        std::uint32_t priorities_count = 0;
+        for (auto&& queue_family : vkphysicaldevice.mQueueFamilies)
+            priorities_count = std::max(priorities_count, queue_family.mProperties.queueCount);
+
+        std::vector<float> priorities(priorities_count, 1.0f);
+        std::vector<VkDeviceQueueCreateInfo> info_queues(vkphysicaldevice.mQueueFamilies.size());
+        for (auto&& [info_queue, queue_family] : zip(info_queues, vkphysicaldevice.mQueueFamilies))
+        {
+            info_queue.sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            info_queue.pNext            = nullptr;
+            info_queue.flags            = 0;
+            info_queue.queueFamilyIndex = queue_family.mIndex;
+            info_queue.queueCount       = queue_family.mProperties.queueCount;
+            info_queue.pQueuePriorities = priorities.data();
+        }
+
+        return blk::Engine(application, vkphysicaldevice, info_queues);
+    }();
+
+    const blk::Queue* queue = engine.mPresentationQueues.at(0);
+
+    // NOTE Declared before the sample, which holds views on them
+    std::vector<blk::Image>                   backbuffers(kBackBufferCount);
+    std::vector<std::unique_ptr<blk::Memory>> backbuffer_memories(kBackBufferCount);
+    std::vector<VkImage>                      backbuffer_images(kBackBufferCount, VK_NULL_HANDLE);
+    for (auto&& [image, memory, vkimage] : zip(backbuffers, backbuffer_memories, backbuffer_images))
+    {
+        image = blk::Image(
+            VkExtent3D{ .width = resolution.width, .height = resolution.height, .depth = 1 },
+            VK_IMAGE_TYPE_2D,
+            kBackBufferFormat,
+            VK_SAMPLE_COUNT_1_BIT,
+            VK_IMAGE_TILING_OPTIMAL,
+            kBackBufferUsage,
+            VK_IMAGE_LAYOUT_UNDEFINED
+        );
+        image.create(engine.mDevice, "Back Buffer");
+
+        auto memory_type = vkphysicaldevice.mMemories.find_compatible(image, 0);
+        assert(memory_type);
+        memory = std::make_unique<blk::Memory>(*memory_type, image.mRequirements.size);
+        memory->allocate(engine.mDevice, "Back Buffer");
+        memory->bind(image);
+
+        vkimage = image;
+    }
+
+    std::vector<VkCommandBuffer> commandbuffers(kBackBufferCount, VK_NULL_HANDLE);
+    {
+        const VkCommandBufferAllocateInfo info{
+            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext              = nullptr,
+            .commandPool        = engine.mPresentationCommandPool,
+            .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = static_cast<std::uint32_t>(commandbuffers.size()),
+        };
+        CHECK(vkAllocateCommandBuffers(engine.mDevice, &info, commandbuffers.data()));
+        for (auto&& commandbuffer : commandbuffers)
+            blk::debug::name(engine.mDevice, commandbuffer, "Bench Frame");
+    }
+
+    VkFence fence = VK_NULL_HANDLE;
+    {
+        const VkFenceCreateInfo info{
+            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = VK_FENCE_CREATE_SIGNALED_BIT,
+        };
+        CHECK(vkCreateFence(engine.mDevice, &info, nullptr, &fence));
+    }
+
+    std::cout.precision(4);
+    std::cout << std::fixed;
+    std::cout << "{\n"
+              << "  \"device\": "     << json_string(vkphysicaldevice.mProperties.deviceName) << ",\n"
+              << "  \"resolution\": [" << resolution.width << ", " << resolution.height << "],\n"
+              << "  \"warmup\": "     << warmup << ",\n"
+              << "  \"frames\": "     << frames << ",\n"
+              << "  \"validation\": " << (application.mEnabledLayers.empty() ? "false" : "true") << ",\n"
+              << "  \"scenarios\": {";
+
+    {
+        blk::sample0::Sample sample(engine, kBackBufferFormat, kBackBufferUsage, backbuffer_images, resolution);
+
+        auto& passui = sample.mPassUIOverlay;
+        // NOTE Every frame is rendered, see Sample::onIdle
+        passui.mUI.render_on_demand = false;
+        // NOTE Not waited here, the first frame does
+        passui.submit_font_image_upload();
+
+        std::size_t frame = 0;
+        bool first_scenario = true;
+        for (auto&& scenario : kScenarios)
+        {
+            if (!scenarios.empty() && (std::ranges::find(scenarios, std::string_view(scenario.name)) == std::ranges::end(scenarios)))
+                continue;
+            if (scenario.replay && !replay)
+                continue;
+
+            Samples samples;
+            samples.record.reserve(frames);
+            samples.upload.reserve(scenario.replay ? frames : 0);
+            samples.submit.reserve(frames);
+            samples.gpu.reserve(frames);
+
+            for (std::size_t idx = 0; idx < warmup + frames; ++idx, ++frame)
+            {
+                const bool measured = idx >= warmup;
+
+                BLK_PROFILE_FRAME();
+                blk::PerformanceWarnings::instance().begin_frame();
+                blk::MemoryTracer::instance().begin_frame();
+                {// Previous frame submission
+                    CHECK(vkWaitForFences(engine.mDevice, 1, &fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max()));
+                    CHECK(vkResetFences(engine.mDevice, 1, &fence));
+                    // NOTE Single frame in flight, every previous frame is complete
+                    engine.mRetireQueue.begin_frame(engine.mRetireQueue.mSerial);
+                    passui.poll_font_image_upload();
+                }
+
+                scenario.script(frame, resolution, passui.mUI, passui.mMouse);
+
+                const std::uint32_t backbufferindex = static_cast<std::uint32_t>(frame % kBackBufferCount);
+                VkCommandBuffer commandbuffer = commandbuffers.at(backbufferindex);
+
+                if (scenario.replay)
+                {// Decoding is left out of timings
+                    const std::array<ImTextureID, 1> textures{ ImGui::GetIO().Fonts->TexID };
+                    passui.mReplayDrawData = &replay->decode(idx % replay->frame_count(), textures);
+                }
+
+                const clock_t::time_point start = clock_t::now();
+                clock_t::time_point uploaded = start;
+                if (scenario.replay)
+                {
+                    passui.optimize_imgui_draw_data();
+                    passui.upload_imgui_draw_data();
+                    uploaded = clock_t::now();
+                }
+                else
+                    sample.onIdle();
+                sample.record(backbufferindex, commandbuffer);
+                const clock_t::time_point recorded = clock_t::now();
+
+                std::vector<VkSemaphore>          wait_semaphores;
+                std::vector<VkPipelineStageFlags> wait_stages;
+                if (VkSemaphore font_semaphore = passui.consume_font_image_semaphore(); font_semaphore != VK_NULL_HANDLE)
+                {
+                    wait_semaphores.push_back(font_semaphore);
+                    wait_stages.push_back(VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+                }
+                blk::Engine::submit(
+                    *queue,
+                    std::span<const VkCommandBuffer>(&commandbuffer, 1),
+                    wait_semaphores,
+                    wait_stages,
+                    std::span<const VkSemaphore>(),
+                    fence
+                );
+                const clock_t::time_point submitted = clock_t::now();
+
+                if (!measured)
+                    continue;
+
+                samples.record.push_back(duration_t(recorded - start).count());
+                if (scenario.replay)
+                    samples.upload.push_back(duration_t(uploaded - start).count());
+                samples.submit.push_back(duration_t(submitted - recorded).count());
+                // NOTE Fetched while recording, i.e. the previous frame GPU time, also measured when idx > warmup
+                //  The latest frame is left out, the next scenario would fetch it
+                if (sample.mTimestamps.supported() && (idx > warmup))
+                    samples.gpu.push_back(sample.mGPUTime);
+                if (sample.mPipelineStatistics.supported() && (idx > warmup))
+                {
+                    for (std::uint32_t index = 0; index < samples.pipeline.size(); ++index)
+                    {
+                        const blk::PipelineStatistics& statistics = sample.mPipelineStatistics.statistics(index);
+                        blk::PipelineStatistics& sums = samples.pipeline[index];
+                        sums.input_assembly_vertices     += statistics.input_assembly_vertices;
+                        sums.input_assembly_primitives   += statistics.input_assembly_primitives;
+                        sums.vertex_shader_invocations   += statistics.vertex_shader_invocations;
+                        sums.clipping_primitives         += statistics.clipping_primitives;
+                        sums.fragment_shader_invocations += statistics.fragment_shader_invocations;
+                    }
+                    ++samples.pipeline_frames;
+                }
+            }
+
+            std::cout << (first_scenario ? "\n" : ",\n")
+                      << "    " << json_string(scenario.name) << ": {\n";
+            report(std::cout, "cpu_record_ms", statistics(samples.record), false);
+            report(std::cout, "cpu_upload_ms", statistics(samples.upload), false);
+            report(std::cout, "cpu_submit_ms", statistics(samples.submit), false);
+            report(std::cout, "gpu_ms"       , statistics(samples.gpu)   , false);
+            report_pipeline_statistics(std::cout, samples);
+            std::cout << "    }";
+            first_scenario = false;
+
+            std::cerr << "Scenario " << scenario.name << ": " << frames << " frames" << std::endl;
+        }
+        passui.mReplayDrawData = nullptr;
+
+        vkDeviceWaitIdle(engine.mDevice);
+        BLK_PROFILE_FRAME();
+    }
+
+    std::cout << "\n  },\n";
+    // NOTE Messages of the whole run, warmup frames included
+    report_performance_warnings(std::cout);
+    std::cout << "}" << std::endl;
+
+    if (trace_path)
+    {
+        std::ofstream stream{std::string(*trace_path)};
+        blk::profiler::Profiler::instance().export_chrome_trace(stream);
+    }
+
+    vkDestroyFence(engine.mDevice, fence, nullptr);
+    vkFreeCommandBuffers(engine.mDevice, engine.mPresentationCommandPool, static_cast<std::uint32_t>(commandbuffers.size()), commandbuffers.data());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+#include "../sample0/uivertex.hpp"
+
+#include <imgui.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <cinttypes>
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+// Compare the plain ImDrawVert copy against the packed UI vertex conversion, both streaming into a destination buffer
+//  Usage: vkplaygrounds-bench-uivertex [vertex count] [iterations]
+
+namespace
+{
+    constexpr std::size_t kDefaultVertexCount = 1 << 16;
+    constexpr std::size_t kDefaultIterations  = 1000;
+
+    struct Result
+    {
+        double seconds;
+        std::size_t bytes;
+    };
+
+    Result measure(std::size_t iterations, std::size_t bytes, const std::function<void()>& work)
+    {
+        // Warm-up
+        work();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t idx = 0; idx < iterations; ++idx)
+            work();
+        const auto stop = std::chrono::high_resolution_clock::now();
+
+        return Result{
+            .seconds = std::chrono::duration<double>(stop - start).count(),
+            .bytes   = bytes,
+        };
+    }
+
+    void report(const char* name, std::size_t count, std::size_t iterations, const Result& result)
+    {
+        const double vertices = static_cast<double>(count) * iterations;
+        std::cout << name << '\n'
+                  << '\t' << "Upload size : " << result.bytes << " bytes" << '\n'
+                  << '\t' << "Throughput  : " << (vertices / result.seconds) * 1e-6 << " Mvertices/s, "
+                                              << (static_cast<double>(result.bytes) * iterations / result.seconds) * 1e-9 << " GB/s written" << '\n'
+                  << '\t' << "Per upload  : " << (result.seconds / iterations) * 1e6 << " us" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t count      = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : kDefaultVertexCount;
+    const std::size_t iterations = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : kDefaultIterations;
+
+    std::vector<ImDrawVert> vertices(count);
+    {// Typical UI content: on-screen positions, font atlas UVs
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> x(-16.0f, 1920.0f);
+        std::uniform_real_distribution<float> y(-16.0f, 1080.0f);
+        std::uniform_real_distribution<float> uv(0.0f, 1.0f);
+        std::uniform_int_distribution<std::uint32_t> color;
+        for (auto&& vertex : vertices)
+        {
+            vertex.pos = ImVec2(x(generator), y(generator));
+            vertex.uv  = ImVec2(uv(generator), uv(generator));
+            vertex.col = color(generator);
+        }
+    }
+
+    std::vector<ImDrawVert>               copied(count);
+    std::vector<blk::sample0::PackedVertex> packed(count);
+    std::vector<blk::sample0::PackedVertex> reference(count);
+
+    {// Validation
+        blk::sample0::pack_vertices(vertices.data(), count, packed.data());
+        blk::sample0::pack_vertices_reference(vertices.data(), count, reference.data());
+        if (std::memcmp(packed.data(), reference.data(), count * sizeof(blk::sample0::PackedVertex)) != 0)
+        {
+            std::cerr << "SIMD kernel output differs from scalar reference" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "Vertices: " << count << ", iterations: " << iterations << std::endl;
+
+    const Result copy = measure(iterations, count * sizeof(ImDrawVert), [&]{
+        std::copy_n(vertices.data(), count, copied.data());
+    });
+    const Result pack = measure(iterations, count * sizeof(blk::sample0::PackedVertex), [&]{
+        blk::sample0::pack_vertices(vertices.data(), count, packed.data());
+    });
+    const Result pack_scalar = measure(iterations, count * sizeof(blk::sample0::PackedVertex), [&]{
+        blk::sample0::pack_vertices_reference(vertices.data(), count, reference.data());
+    });
+
+    report("Copy (ImDrawVert)"         , count, iterations, copy);
+    report("Pack (PackedVertex, SIMD)"  , count, iterations, pack);
+    report("Pack (PackedVertex, scalar)", count, iterations, pack_scalar);
+
+    std::cout << "Upload size ratio: " << static_cast<double>(pack.bytes) / static_cast<double>(copy.bytes) << std::endl;
+
+    return EXIT_SUCCESS;
+}
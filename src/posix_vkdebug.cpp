@@ -0,0 +1,27 @@
+#include <vulkan/vulkan.h>
+
+#include <cassert>
+
+#include "./vkdebug.hpp"
+
+// NOTE No debugger integration, failures are reported by assertions and messages end up on the standard error
+
+void CHECK(const VkResult& v)
+{
+    assert(v == VK_SUCCESS);
+}
+
+void CHECK(bool v)
+{
+    assert(v);
+}
+
+VkBool32 DebuggerCallback(
+    VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+    VkDebugUtilsMessageTypeFlagsEXT messageType,
+    const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
+    void* pUserData)
+{
+    // NOTE StandardErrorDebugCallback already reports everything
+    return VK_FALSE;
+}
@@ -0,0 +1,372 @@
+#include "./uidrawcapture.hpp"
+
+#include <imgui.h>
+#include <hash.hpp>
+
+#if defined(OS_WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+#include <cinttypes>
+
+#include <span>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+
+namespace
+{
+    constexpr std::size_t padded(std::size_t size)
+    {
+        return (size + 3) & ~std::size_t(3);
+    }
+
+    void append(std::vector<std::byte>& stream, const void* data, std::size_t size)
+    {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        stream.insert(std::end(stream), bytes, bytes + size);
+        stream.resize(padded(stream.size()), std::byte{0});
+    }
+
+    template<typename T>
+    void append(std::vector<std::byte>& stream, const T& value)
+    {
+        append(stream, &value, sizeof(T));
+    }
+
+    // Copy of a trivial value at offset, false when it would read past size
+    template<typename T>
+    bool read(const std::byte* address, std::size_t size, std::size_t offset, T& value)
+    {
+        if ((offset > size) || (size - offset < sizeof(T)))
+            return false;
+
+        std::memcpy(&value, address + offset, sizeof(T));
+        return true;
+    }
+
+    struct ListCounts
+    {
+        std::uint32_t vertex_count;
+        std::uint32_t index_count;
+    };
+
+    // Whether the frame spanning [offset, end) only reads within itself, and its commands within their draw list
+    //  counts holds the vertex and index counts last recorded per list id, updated with the frame ones
+    bool validate_frame(const std::byte* address, std::size_t end, std::size_t offset, std::vector<ListCounts>& counts)
+    {
+        using namespace blk::sample0;
+
+        DrawDataFrameHeader header;
+        if (!read(address, end, offset, header))
+            return false;
+        offset += sizeof(header);
+
+        for (std::uint32_t idx_list = 0; idx_list < header.list_count; ++idx_list)
+        {
+            DrawDataListHeader list;
+            if (!read(address, end, offset, list))
+                return false;
+            offset += sizeof(list);
+
+            // NOTE ImVector sizes are int
+            constexpr std::uint32_t kMaxCount = static_cast<std::uint32_t>(std::numeric_limits<int>::max());
+            if ((list.command_count > kMaxCount) || (list.vertex_count > kMaxCount) || (list.index_count > kMaxCount))
+                return false;
+
+            // NOTE Ids are given in order of first recording
+            const bool unchanged = (list.flags & DrawDataListHeader::kUnchanged) != 0;
+            if ((list.id > counts.size()) || ((list.id == counts.size()) && unchanged))
+                return false;
+            if (unchanged && ((counts[list.id].vertex_count != list.vertex_count) || (counts[list.id].index_count != list.index_count)))
+                return false;
+
+            if (list.command_count > (end - offset) / sizeof(DrawDataCommand))
+                return false;
+            for (std::uint32_t idx_command = 0; idx_command < list.command_count; ++idx_command)
+            {
+                DrawDataCommand command;
+                read(address, end, offset, command);
+                offset += sizeof(command);
+
+                const bool inside = (std::uint64_t{command.index_offset} + command.element_count <= list.index_count)
+                                 && (command.vertex_offset <= list.vertex_count);
+                if (!inside)
+                    return false;
+            }
+
+            if (unchanged)
+                continue;
+
+            const std::size_t bytes = padded(std::size_t{list.vertex_count} * sizeof(ImDrawVert)) + padded(std::size_t{list.index_count} * sizeof(ImDrawIdx));
+            if (end - offset < bytes)
+                return false;
+            offset += bytes;
+
+            if (list.id == counts.size())
+                counts.push_back(ListCounts{});
+            counts[list.id] = ListCounts{ .vertex_count = list.vertex_count, .index_count = list.index_count };
+        }
+        return true;
+    }
+}
+
+namespace blk::sample0
+{
+
+DrawDataRecorder::DrawDataRecorder(const std::string& path)
+    : mStream(path, std::ios::binary | std::ios::trunc)
+{
+    const DrawDataFileHeader header{
+        .magic       = DrawDataFileHeader::kMagic,
+        .version     = DrawDataFileHeader::kVersion,
+        .vertex_size = sizeof(ImDrawVert),
+        .index_size  = sizeof(ImDrawIdx),
+    };
+    mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void DrawDataRecorder::record(const ImDrawData& data)
+{
+    assert(data.Valid);
+
+    mFrame.clear();
+    append(mFrame, DrawDataFrameHeader{
+        .size              = 0,
+        .list_count        = static_cast<std::uint32_t>(data.CmdListsCount),
+        .display_pos       = { data.DisplayPos.x      , data.DisplayPos.y       },
+        .display_size      = { data.DisplaySize.x     , data.DisplaySize.y      },
+        .framebuffer_scale = { data.FramebufferScale.x, data.FramebufferScale.y },
+    });
+
+    for (auto idx_list = 0, count_list = data.CmdListsCount; idx_list < count_list; ++idx_list)
+    {
+        const ImDrawList* list = data.CmdLists[idx_list];
+        const std::size_t vertex_bytes = list->VtxBuffer.Size * sizeof(ImDrawVert);
+        const std::size_t index_bytes  = list->IdxBuffer.Size * sizeof(ImDrawIdx);
+
+        auto [finder, inserted] = mListIds.try_emplace(list, static_cast<std::uint32_t>(mListHashes.size()));
+        if (inserted)
+            mListHashes.push_back(0);
+
+        const std::uint32_t id   = finder->second;
+        const std::uint64_t hash = content_hash(list->IdxBuffer.Data, index_bytes, content_hash(list->VtxBuffer.Data, vertex_bytes));
+        const bool unchanged = !inserted && (mListHashes[id] == hash);
+        mListHashes[id] = hash;
+
+        append(mFrame, DrawDataListHeader{
+            .id            = id,
+            .flags         = unchanged ? DrawDataListHeader::kUnchanged : 0,
+            .command_count = static_cast<std::uint32_t>(list->CmdBuffer.Size),
+            .vertex_count  = static_cast<std::uint32_t>(list->VtxBuffer.Size),
+            .index_count   = static_cast<std::uint32_t>(list->IdxBuffer.Size),
+        });
+
+        for (auto&& command : list->CmdBuffer)
+        {
+            assert(command.UserCallback == nullptr);
+
+            auto texture = std::ranges::find(mTextures, command.TextureId);
+            if (texture == std::end(mTextures))
+                texture = mTextures.insert(texture, command.TextureId);
+
+            append(mFrame, DrawDataCommand{
+                .clip_rect     = { command.ClipRect.x, command.ClipRect.y, command.ClipRect.z, command.ClipRect.w },
+                .texture       = static_cast<std::uint32_t>(std::distance(std::begin(mTextures), texture)),
+                .vertex_offset = command.VtxOffset,
+                .index_offset  = command.IdxOffset,
+                .element_count = command.ElemCount,
+            });
+        }
+
+        if (unchanged)
+            continue;
+
+        append(mFrame, list->VtxBuffer.Data, vertex_bytes);
+        append(mFrame, list->IdxBuffer.Data, index_bytes);
+    }
+
+    // NOTE Patched once the frame size is known
+    const auto size = static_cast<std::uint32_t>(mFrame.size());
+    std::memcpy(mFrame.data() + offsetof(DrawDataFrameHeader, size), &size, sizeof(size));
+
+    mStream.write(reinterpret_cast<const char*>(mFrame.data()), static_cast<std::streamsize>(mFrame.size()));
+    ++mFrameCount;
+}
+
+DrawDataReplay::DrawDataReplay(const std::string& path)
+{
+    {// Mapping
+        #if defined(OS_WINDOWS)
+        mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE)
+        {
+            mFile = nullptr;
+            return;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFile, &size) || (size.QuadPart == 0))
+            return;
+
+        mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mMapping == nullptr)
+            return;
+
+        mAddress = static_cast<const std::byte*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+        mSize    = (mAddress != nullptr) ? static_cast<std::size_t>(size.QuadPart) : 0;
+        #else
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            return;
+
+        struct stat status;
+        if ((fstat(file, &status) == 0) && (status.st_size > 0))
+        {
+            void* address = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if (address != MAP_FAILED)
+            {
+                mAddress = static_cast<const std::byte*>(address);
+                mSize    = static_cast<std::size_t>(status.st_size);
+            }
+        }
+        // NOTE Mapping outlives the descriptor
+        close(file);
+        #endif
+    }
+
+    DrawDataFileHeader header;
+    if (!read(mAddress, mSize, 0, header))
+        return;
+
+    const bool compatible = (header.magic       == DrawDataFileHeader::kMagic)
+                         && (header.version     == DrawDataFileHeader::kVersion)
+                         && (header.vertex_size == sizeof(ImDrawVert))
+                         && (header.index_size  == sizeof(ImDrawIdx));
+    if (!compatible)
+        return;
+
+    {// Frames
+        // NOTE Replay stops before the first truncated (e.g. recording interrupted) or inconsistent frame, later ones may reference its lists
+        std::vector<ListCounts> counts;
+        DrawDataFrameHeader frame;
+        for (std::size_t offset = sizeof(header); read(mAddress, mSize, offset, frame) && (frame.size >= sizeof(frame)) && (mSize - offset >= frame.size); offset += frame.size)
+        {
+            if (!validate_frame(mAddress, offset + frame.size, offset, counts))
+                break;
+            mFrames.push_back(offset);
+        }
+    }
+}
+
+DrawDataReplay::~DrawDataReplay()
+{
+    #if defined(OS_WINDOWS)
+    if (mAddress != nullptr)
+        UnmapViewOfFile(mAddress);
+    if (mMapping != nullptr)
+        CloseHandle(mMapping);
+    if (mFile != nullptr)
+        CloseHandle(mFile);
+    #else
+    if (mAddress != nullptr)
+        munmap(const_cast<std::byte*>(mAddress), mSize);
+    #endif
+}
+
+const ImDrawData& DrawDataReplay::decode(std::size_t frame, std::span<const ImTextureID> textures)
+{
+    assert(frame < mFrames.size());
+
+    // NOTE Frame layout was validated when indexing frames, see validate_frame
+    std::size_t offset = mFrames[frame];
+    DrawDataFrameHeader header;
+    read(mAddress, mSize, offset, header);
+    const std::size_t end = offset + header.size;
+    offset += sizeof(header);
+
+    mDrawData.Clear();
+    mCmdLists.clear();
+    for (std::uint32_t idx_list = 0; idx_list < header.list_count; ++idx_list)
+    {
+        DrawDataListHeader list_header;
+        if (!read(mAddress, end, offset, list_header))
+            break;
+        offset += sizeof(list_header);
+
+        const std::size_t commands_offset = offset;
+        offset += std::size_t{list_header.command_count} * sizeof(DrawDataCommand);
+
+        const bool unchanged = (list_header.flags & DrawDataListHeader::kUnchanged) != 0;
+        if (unchanged)
+        {
+            // NOTE Frames decoded out of order, the list content as recorded is unknown, it is left out rather than drawn out of bounds
+            const bool known = (list_header.id < mLists.size()) && mLists[list_header.id]
+                && (mLists[list_header.id]->VtxBuffer.Size == static_cast<int>(list_header.vertex_count))
+                && (mLists[list_header.id]->IdxBuffer.Size == static_cast<int>(list_header.index_count));
+            if (!known)
+                continue;
+        }
+
+        if (list_header.id >= mLists.size())
+            mLists.resize(list_header.id + 1);
+        if (!mLists[list_header.id])
+            mLists[list_header.id] = std::make_unique<ImDrawList>(nullptr);
+        ImDrawList& list = *mLists[list_header.id];
+
+        list.CmdBuffer.resize(static_cast<int>(list_header.command_count));
+        for (int idx_command = 0; idx_command < list.CmdBuffer.Size; ++idx_command)
+        {
+            DrawDataCommand recorded;
+            [[maybe_unused]] const bool complete = read(mAddress, end, commands_offset + idx_command * sizeof(DrawDataCommand), recorded);
+            assert(complete);
+
+            ImDrawCmd& command = list.CmdBuffer[idx_command];
+            command = ImDrawCmd();
+            command.ClipRect  = ImVec4(recorded.clip_rect[0], recorded.clip_rect[1], recorded.clip_rect[2], recorded.clip_rect[3]);
+            command.TextureId = textures.empty() ? nullptr : textures[std::min<std::size_t>(recorded.texture, textures.size() - 1)];
+            command.VtxOffset = recorded.vertex_offset;
+            command.IdxOffset = recorded.index_offset;
+            command.ElemCount = recorded.element_count;
+        }
+
+        if (!unchanged)
+        {
+            const std::size_t vertex_bytes = std::size_t{list_header.vertex_count} * sizeof(ImDrawVert);
+            const std::size_t index_bytes  = std::size_t{list_header.index_count}  * sizeof(ImDrawIdx);
+            assert(end - offset >= padded(vertex_bytes) + padded(index_bytes));
+
+            list.VtxBuffer.resize(static_cast<int>(list_header.vertex_count));
+            std::memcpy(list.VtxBuffer.Data, mAddress + offset, vertex_bytes);
+            offset += padded(vertex_bytes);
+
+            list.IdxBuffer.resize(static_cast<int>(list_header.index_count));
+            std::memcpy(list.IdxBuffer.Data, mAddress + offset, index_bytes);
+            offset += padded(index_bytes);
+        }
+
+        mCmdLists.push_back(&list);
+        mDrawData.TotalVtxCount += list.VtxBuffer.Size;
+        mDrawData.TotalIdxCount += list.IdxBuffer.Size;
+    }
+
+    mDrawData.Valid            = true;
+    mDrawData.CmdLists         = mCmdLists.data();
+    mDrawData.CmdListsCount    = static_cast<int>(mCmdLists.size());
+    mDrawData.DisplayPos       = ImVec2(header.display_pos[0]      , header.display_pos[1]      );
+    mDrawData.DisplaySize      = ImVec2(header.display_size[0]     , header.display_size[1]     );
+    mDrawData.FramebufferScale = ImVec2(header.framebuffer_scale[0], header.framebuffer_scale[1]);
+    return mDrawData;
+}
+
+}
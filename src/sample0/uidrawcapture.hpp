@@ -0,0 +1,123 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <span>
+#include <memory>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+
+namespace blk::sample0
+{
+    // Binary stream of ImDrawData, one frame after another
+    //  - header   : DrawDataFileHeader
+    //  - frame    : DrawDataFrameHeader, then per draw list
+    //  - list     : DrawDataListHeader, DrawDataCommand[], then (unless unchanged) ImDrawVert[] and ImDrawIdx[] padded to 4 bytes
+    //  NOTE Native endianness and layouts, a capture is only meant to be replayed by the build which recorded it
+    struct DrawDataFileHeader
+    {
+        static constexpr std::uint32_t kMagic   = 0x49554B42; // "BKUI"
+        static constexpr std::uint32_t kVersion = 1;
+
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t vertex_size;
+        std::uint32_t index_size;
+    };
+
+    struct DrawDataFrameHeader
+    {
+        // In bytes, this header included
+        std::uint32_t size;
+        std::uint32_t list_count;
+        float         display_pos[2];
+        float         display_size[2];
+        float         framebuffer_scale[2];
+    };
+
+    struct DrawDataListHeader
+    {
+        // Vertices and indices are the ones last recorded for this id, and omitted
+        static constexpr std::uint32_t kUnchanged = 1 << 0;
+
+        // Stable across frames for the same ImDrawList, i.e. the same window
+        std::uint32_t id;
+        std::uint32_t flags;
+        std::uint32_t command_count;
+        std::uint32_t vertex_count;
+        std::uint32_t index_count;
+    };
+
+    struct DrawDataCommand
+    {
+        float         clip_rect[4];
+        // Index of the texture in order of first use, see DrawDataReplay::decode
+        std::uint32_t texture;
+        std::uint32_t vertex_offset;
+        std::uint32_t index_offset;
+        std::uint32_t element_count;
+    };
+
+    // Serialize every ImDrawData rendered into a file, e.g. from a production session
+    //  Draw lists whose content did not change since the previous frame are only referenced
+    struct DrawDataRecorder
+    {
+        explicit DrawDataRecorder(const std::string& path);
+
+        // NOTE Draw callbacks are not supported
+        void record(const ImDrawData& data);
+
+        std::ofstream                                        mStream;
+        std::vector<std::byte>                               mFrame;
+        std::unordered_map<const ImDrawList*, std::uint32_t> mListIds;
+        // Per list id, content hash as last recorded
+        std::vector<std::uint64_t>                           mListHashes;
+        std::vector<ImTextureID>                             mTextures;
+        std::uint32_t                                        mFrameCount = 0;
+    };
+
+    // Memory-mapped capture, decoded frame by frame into an ImDrawData
+    //  Draw lists are persistent per id, as ImGui windows are, so that per-list caching behaves as when recorded
+    struct DrawDataReplay
+    {
+        explicit DrawDataReplay(const std::string& path);
+        ~DrawDataReplay();
+
+        DrawDataReplay(const DrawDataReplay& rhs) = delete;
+        DrawDataReplay& operator=(const DrawDataReplay& rhs) = delete;
+
+        // Whether the file was mapped and is a valid capture
+        [[nodiscard]] bool valid() const
+        {
+            return !mFrames.empty();
+        }
+
+        [[nodiscard]] std::size_t frame_count() const
+        {
+            return mFrames.size();
+        }
+
+        // Draw data of a frame, valid until the next call
+        //  NOTE Frames are meant to be decoded in order, unchanged lists keep the content of a previous decode
+        //  textures[i] replaces recorded texture i, the last one is used for any other
+        const ImDrawData& decode(std::size_t frame, std::span<const ImTextureID> textures);
+
+        const std::byte*                         mAddress = nullptr;
+        std::size_t                              mSize    = 0;
+        #if defined(OS_WINDOWS)
+        void*                                    mFile    = nullptr;
+        void*                                    mMapping = nullptr;
+        #endif
+
+        // Offsets of each frame header
+        std::vector<std::size_t>                 mFrames;
+        std::vector<std::unique_ptr<ImDrawList>> mLists;
+        std::vector<ImDrawList*>                 mCmdLists;
+        ImDrawData                               mDrawData;
+    };
+}
@@ -0,0 +1,58 @@
+#include "./uiinputcapture.hpp"
+
+#include <cinttypes>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace blk::sample0
+{
+
+InputRecorder::InputRecorder(const std::string& path, const VkExtent2D& resolution)
+    : mStream(path, std::ios::binary | std::ios::trunc)
+    , mStart(std::chrono::steady_clock::now())
+{
+    const InputFileHeader header{
+        .magic      = InputFileHeader::kMagic,
+        .version    = InputFileHeader::kVersion,
+        .frame_size = sizeof(InputFrame),
+        .width      = resolution.width,
+        .height     = resolution.height,
+    };
+    mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void InputRecorder::record(InputFrame frame)
+{
+    frame.timestamp = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count());
+    mStream.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    ++mFrameCount;
+}
+
+InputReplay::InputReplay(const std::string& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+
+    InputFileHeader header{};
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return;
+
+    const bool compatible = (header.magic      == InputFileHeader::kMagic)
+                         && (header.version    == InputFileHeader::kVersion)
+                         && (header.frame_size == sizeof(InputFrame));
+    if (!compatible)
+        return;
+
+    mResolution = VkExtent2D{ .width = header.width, .height = header.height };
+
+    // NOTE A truncated last frame, e.g. recording interrupted, is left out
+    InputFrame frame;
+    while (stream.read(reinterpret_cast<char*>(&frame), sizeof(frame)))
+        mFrames.push_back(frame);
+
+    mValid = true;
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace blk::sample0
+{
+    // Input and timing sampled by an ImGui frame, see PassUIOverlay::render_imgui_frame
+    //  NOTE Input events received between two frames are already coalesced into a single state (e.g. wheel deltas accumulated)
+    struct InputFrame
+    {
+        static constexpr std::uint32_t kButtonLeft   = 1 << 0;
+        static constexpr std::uint32_t kButtonRight  = 1 << 1;
+        static constexpr std::uint32_t kButtonMiddle = 1 << 2;
+
+        // Nanoseconds since the recording started
+        std::uint64_t timestamp;
+        // Measured frame delta, as fed to ImGuiIO::DeltaTime
+        float         delta;
+        float         mouse[2];
+        float         wheel[2];
+        std::uint32_t buttons;
+    };
+
+    // Binary stream : InputFileHeader, then InputFrame one after another
+    struct InputFileHeader
+    {
+        static constexpr std::uint32_t kMagic   = 0x4E494B42; // "BKIN"
+        static constexpr std::uint32_t kVersion = 1;
+
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t frame_size;
+        // Resolution when recording started, replaying at another one changes what the mouse hovers
+        std::uint32_t width;
+        std::uint32_t height;
+    };
+
+    struct InputRecorder
+    {
+        InputRecorder(const std::string& path, const VkExtent2D& resolution);
+
+        void record(InputFrame frame);
+
+        std::ofstream                         mStream;
+        std::chrono::steady_clock::time_point mStart;
+        std::uint32_t                         mFrameCount = 0;
+    };
+
+    // Recorded frames, fed one per ImGui frame
+    struct InputReplay
+    {
+        explicit InputReplay(const std::string& path);
+
+        // Whether the file is a valid recording
+        [[nodiscard]] bool valid() const
+        {
+            return mValid;
+        }
+
+        [[nodiscard]] bool finished() const
+        {
+            return mCursor >= mFrames.size();
+        }
+
+        // NOTE Not finished
+        const InputFrame& next()
+        {
+            return mFrames[mCursor++];
+        }
+
+        bool                    mValid      = false;
+        VkExtent2D              mResolution = {};
+        std::vector<InputFrame> mFrames;
+        std::size_t             mCursor     = 0;
+    };
+}
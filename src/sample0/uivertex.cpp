@@ -0,0 +1,178 @@
+#include "./uivertex.hpp"
+
+#include <imgui.h>
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define BLK_UIVERTEX_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   include <emmintrin.h>
+#   define BLK_UIVERTEX_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#   include <arm_neon.h>
+#   define BLK_UIVERTEX_NEON
+#endif
+
+namespace
+{
+    using blk::sample0::PackedVertex;
+    using blk::sample0::kPackedPositionScale;
+
+    constexpr float kUVScale = 65535.0f;
+
+    // NOTE Kernels read pos & uv as 4 consecutive floats
+    static_assert(offsetof(ImDrawVert, pos) == 0);
+    static_assert(offsetof(ImDrawVert, uv ) == 2 * sizeof(float));
+
+    // NOTE Rounding to nearest even, as SIMD float -> int conversions in default rounding mode
+    PackedVertex pack(const ImDrawVert& vertex)
+    {
+        auto position = [](float v) {
+            return static_cast<std::int16_t>(std::nearbyint(std::clamp(v * kPackedPositionScale, -32768.0f, 32767.0f)));
+        };
+        auto uv = [](float v) {
+            return static_cast<std::uint16_t>(std::nearbyint(std::clamp(v * kUVScale, 0.0f, kUVScale)));
+        };
+        return PackedVertex{
+            .pos = { position(vertex.pos.x), position(vertex.pos.y) },
+            .uv  = { uv(vertex.uv.x), uv(vertex.uv.y) },
+            .col = vertex.col,
+        };
+    }
+
+    #if defined(BLK_UIVERTEX_AVX2) || defined(BLK_UIVERTEX_SSE2)
+    // Store the 8 bytes pos/uv block then the color of one vertex
+    inline void store(PackedVertex* packed, __m128i posuv, ImU32 color)
+    {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(packed), posuv);
+        std::memcpy(&(packed->col), &color, sizeof(color));
+    }
+    #endif
+
+    #if defined(BLK_UIVERTEX_AVX2)
+    // 4 vertices per iteration
+    std::size_t pack_avx2(const ImDrawVert* vertices, std::size_t count, PackedVertex* packed)
+    {
+        const __m256 scale = _mm256_setr_ps(
+            kPackedPositionScale, kPackedPositionScale, kUVScale, kUVScale,
+            kPackedPositionScale, kPackedPositionScale, kUVScale, kUVScale
+        );
+        const __m256 lower = _mm256_setr_ps(-32768.0f, -32768.0f, 0.0f, 0.0f, -32768.0f, -32768.0f, 0.0f, 0.0f);
+        const __m256 upper = _mm256_setr_ps( 32767.0f,  32767.0f, kUVScale, kUVScale, 32767.0f,  32767.0f, kUVScale, kUVScale);
+        // UV are biased into signed range to survive signed saturation, then flipped back
+        const __m256i bias = _mm256_setr_epi32(0, 0, -32768, -32768, 0, 0, -32768, -32768);
+        const __m256i flip = _mm256_setr_epi16(
+            0, 0, -32768, -32768, 0, 0, -32768, -32768,
+            0, 0, -32768, -32768, 0, 0, -32768, -32768
+        );
+
+        auto convert = [&](const ImDrawVert* a, const ImDrawVert* b) {
+            const __m256 v = _mm256_insertf128_ps(
+                _mm256_castps128_ps256(_mm_loadu_ps(&(a->pos.x))),
+                _mm_loadu_ps(&(b->pos.x)),
+                1
+            );
+            const __m256 clamped = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(v, scale), lower), upper);
+            return _mm256_add_epi32(_mm256_cvtps_epi32(clamped), bias);
+        };
+
+        std::size_t idx = 0;
+        for (; idx + 4 <= count; idx += 4)
+        {
+            const ImDrawVert* v = vertices + idx;
+            // NOTE packs works per 128-bit lane: [v0 v2 | v1 v3]
+            const __m256i words = _mm256_xor_si256(_mm256_packs_epi32(convert(v + 0, v + 1), convert(v + 2, v + 3)), flip);
+            const __m128i low   = _mm256_castsi256_si128(words);
+            const __m128i high  = _mm256_extracti128_si256(words, 1);
+            store(packed + idx + 0, low                        , v[0].col);
+            store(packed + idx + 1, high                       , v[1].col);
+            store(packed + idx + 2, _mm_unpackhi_epi64(low, low), v[2].col);
+            store(packed + idx + 3, _mm_unpackhi_epi64(high, high), v[3].col);
+        }
+        return idx;
+    }
+    #endif
+
+    #if defined(BLK_UIVERTEX_SSE2)
+    // 2 vertices per iteration
+    std::size_t pack_sse2(const ImDrawVert* vertices, std::size_t count, PackedVertex* packed)
+    {
+        const __m128  scale = _mm_setr_ps(kPackedPositionScale, kPackedPositionScale, kUVScale, kUVScale);
+        const __m128  lower = _mm_setr_ps(-32768.0f, -32768.0f, 0.0f, 0.0f);
+        const __m128  upper = _mm_setr_ps( 32767.0f,  32767.0f, kUVScale, kUVScale);
+        // UV are biased into signed range to survive signed saturation, then flipped back
+        const __m128i bias  = _mm_setr_epi32(0, 0, -32768, -32768);
+        const __m128i flip  = _mm_setr_epi16(0, 0, -32768, -32768, 0, 0, -32768, -32768);
+
+        auto convert = [&](const ImDrawVert* vertex) {
+            const __m128 clamped = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(&(vertex->pos.x)), scale), lower), upper);
+            return _mm_add_epi32(_mm_cvtps_epi32(clamped), bias);
+        };
+
+        std::size_t idx = 0;
+        for (; idx + 2 <= count; idx += 2)
+        {
+            const ImDrawVert* v = vertices + idx;
+            const __m128i words = _mm_xor_si128(_mm_packs_epi32(convert(v + 0), convert(v + 1)), flip);
+            store(packed + idx + 0, words                          , v[0].col);
+            store(packed + idx + 1, _mm_unpackhi_epi64(words, words), v[1].col);
+        }
+        return idx;
+    }
+    #endif
+
+    #if defined(BLK_UIVERTEX_NEON)
+    // 1 vertex per iteration, saturating narrows handle both signed position and unsigned uv
+    std::size_t pack_neon(const ImDrawVert* vertices, std::size_t count, PackedVertex* packed)
+    {
+        const float scale_values[4] = { kPackedPositionScale, kPackedPositionScale, kUVScale, kUVScale };
+        const float lower_values[4] = { -32768.0f, -32768.0f, 0.0f, 0.0f };
+        const float upper_values[4] = {  32767.0f,  32767.0f, kUVScale, kUVScale };
+        const std::uint16_t mask_values[4] = { 0, 0, 0xFFFF, 0xFFFF };
+
+        const float32x4_t scale = vld1q_f32(scale_values);
+        const float32x4_t lower = vld1q_f32(lower_values);
+        const float32x4_t upper = vld1q_f32(upper_values);
+        const uint16x4_t  mask  = vld1_u16(mask_values);
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            const float32x4_t clamped = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(&(vertices[idx].pos.x)), scale), lower), upper);
+            const int32x4_t   words   = vcvtnq_s32_f32(clamped);
+            const uint16x4_t  posuv   = vbsl_u16(mask, vqmovun_s32(words), vreinterpret_u16_s16(vqmovn_s32(words)));
+            vst1_u16(reinterpret_cast<std::uint16_t*>(packed + idx), posuv);
+            std::memcpy(&(packed[idx].col), &(vertices[idx].col), sizeof(ImU32));
+        }
+        return count;
+    }
+    #endif
+}
+
+namespace blk::sample0
+{
+
+void pack_vertices(const ImDrawVert* vertices, std::size_t count, PackedVertex* packed)
+{
+    std::size_t idx = 0;
+    #if defined(BLK_UIVERTEX_AVX2)
+        idx = pack_avx2(vertices, count, packed);
+    #elif defined(BLK_UIVERTEX_SSE2)
+        idx = pack_sse2(vertices, count, packed);
+    #elif defined(BLK_UIVERTEX_NEON)
+        idx = pack_neon(vertices, count, packed);
+    #endif
+    pack_vertices_reference(vertices + idx, count - idx, packed + idx);
+}
+
+void pack_vertices_reference(const ImDrawVert* vertices, std::size_t count, PackedVertex* packed)
+{
+    for (std::size_t idx = 0; idx < count; ++idx)
+        packed[idx] = pack(vertices[idx]);
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cinttypes>
+
+struct ImDrawVert;
+
+namespace blk::sample0
+{
+    // Quantized ImDrawVert (12 bytes instead of 20)
+    //  - position : 13.3 signed fixed point, i.e. [-4096, 4096[ pixels with 1/8 sub-pixel precision
+    //  - uv       : unorm16
+    //  - color    : unchanged RGBA8
+    struct PackedVertex
+    {
+        std::int16_t  pos[2];
+        std::uint16_t uv[2];
+        std::uint32_t col;
+    };
+    static_assert(sizeof(PackedVertex) == 12, "expected tightly packed vertex");
+
+    // Fixed point scale of PackedVertex::pos, decoded in shader with its inverse
+    constexpr float kPackedPositionScale = 8.0f;
+
+    // Convert vertices, best SIMD kernel available for the target (AVX2, SSE2, NEON) or scalar fallback
+    //  NOTE packed may point to (write-combined) mapped memory, it is only written sequentially
+    void pack_vertices(const ImDrawVert* vertices, std::size_t count, PackedVertex* packed);
+
+    // Scalar implementation, produces the same output as pack_vertices
+    void pack_vertices_reference(const ImDrawVert* vertices, std::size_t count, PackedVertex* packed);
+}
@@ -1,52 +1,279 @@
 #include "./vkpassscene.hpp"
 
+#include "./vkutilities.hpp"
 #include "./vkdebug.hpp"
+#include "./vkdebugutils.hpp"
+#include "./vkengine.hpp"
+
+#include "./vkphysicaldevice.hpp"
+#include "./vkmemory.hpp"
+#include "./vkstartupprofiler.hpp"
 
 #include "triangle-shader.hpp"
+#include "upscale-shader.hpp"
 
 #include <vulkan/vulkan_core.h>
 
 #include <cassert>
 
+#include <array>
+#include <utility>
+
 namespace
 {
     constexpr std::uint32_t kStencilMask      = 0xFF;
     constexpr std::uint32_t kStencilReference = 0x01;
+
+    constexpr std::uint32_t kShaderBindingSceneTexture = 0;
+
+    struct alignas(4) UpscaleConstants {
+        float scale    [2];
+        float extent   [2];
+        float texel    [2];
+        float sharpness;
+    };
 }
 
 namespace blk::sample0
 {
 
+PassScene::OffscreenRenderPass::OffscreenRenderPass(const blk::Device& vkdevice, VkFormat formatColor)
+    : blk::RenderPass(vkdevice)
+{
+    // Pass 0 : Draw Scene (write color)
+    //  Color sampled by the main pass upscale
+    const std::array attachments{
+        VkAttachmentDescription{
+            .flags          = 0,
+            .format         = formatColor,
+            .samples        = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
+            .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        },
+    };
+
+    constexpr std::uint32_t kSubpassScene = 0;
+
+    constexpr std::uint32_t kAttachmentColor = 0;
+
+    constexpr VkAttachmentReference write_color_reference{
+        .attachment = kAttachmentColor,
+        .layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+    };
+    const/*expr*/ std::array subpasses{
+        VkSubpassDescription{
+            .flags                   = 0,
+            .pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .inputAttachmentCount    = 0,
+            .pInputAttachments       = nullptr,
+            .colorAttachmentCount    = 1,
+            .pColorAttachments       = &write_color_reference,
+            .pResolveAttachments     = nullptr,
+            .pDepthStencilAttachment = nullptr,
+            .preserveAttachmentCount = 0,
+            .pPreserveAttachments    = nullptr,
+        },
+    };
+    const/*expr*/ std::array dependencies{
+        // Previous frame upscale is done before overwriting the image
+        VkSubpassDependency{
+            .srcSubpass      = VK_SUBPASS_EXTERNAL,
+            .dstSubpass      = kSubpassScene,
+            .srcStageMask    = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            .dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .srcAccessMask   = 0,
+            .dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dependencyFlags = 0,
+        },
+        // Image is visible to the main pass upscale
+        VkSubpassDependency{
+            .srcSubpass      = kSubpassScene,
+            .dstSubpass      = VK_SUBPASS_EXTERNAL,
+            .srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .dstStageMask    = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            .srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask   = VK_ACCESS_SHADER_READ_BIT,
+            .dependencyFlags = 0,
+        },
+    };
+    const VkRenderPassCreateInfo info{
+        .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .pNext           = nullptr,
+        .flags           = 0,
+        .attachmentCount = attachments.size(),
+        .pAttachments    = attachments.data(),
+        .subpassCount    = subpasses.size(),
+        .pSubpasses      = subpasses.data(),
+        .dependencyCount = dependencies.size(),
+        .pDependencies   = dependencies.data(),
+    };
+    CHECK(create(info));
+}
+
 PassScene::PassScene(const blk::RenderPass& renderpass, std::uint32_t subpass, Arguments arguments)
     : Pass(renderpass, subpass)
     , mEngine(arguments.engine)
     , mDevice(renderpass.mDevice)
     , mResolution(arguments.resolution)
+    , mPipeline(mDevice)
+    , mOffscreenFormat(arguments.color_format)
+    , mOffscreenRenderPass(mDevice, arguments.color_format)
+    , mOffscreenPipeline(mDevice)
+    , mUpscalePipeline(mDevice)
 {
+    const blk::StartupPhase phase(kName);
+    {// Sampler
+        // NOTE Bilinear, upscale clamps its taps to the rendered region
+        constexpr VkSamplerCreateInfo info{
+            .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+            .pNext                   = nullptr,
+            .flags                   = 0,
+            .magFilter               = VK_FILTER_LINEAR,
+            .minFilter               = VK_FILTER_LINEAR,
+            .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+            .addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .mipLodBias              = 0.0f,
+            .anisotropyEnable        = VK_FALSE,
+            .maxAnisotropy           = 1.0f,
+            .compareEnable           = VK_FALSE,
+            .compareOp               = VK_COMPARE_OP_NEVER,
+            .minLod                  = 0.0f,
+            .maxLod                  = 0.0f,
+            .borderColor             = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK,
+            .unnormalizedCoordinates = VK_FALSE,
+        };
+        CHECK(vkCreateSampler(mDevice, &info, nullptr, &mUpscaleSampler));
+    }
+    {// Descriptor Pools
+        constexpr std::array kDescriptorPools{
+            // 1 sampler : offscreen scene
+            VkDescriptorPoolSize{
+                .type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .descriptorCount = 1,
+            }
+        };
+        const VkDescriptorPoolCreateInfo info{
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .pNext         = nullptr,
+            .flags         = 0,
+            .maxSets       = 1,
+            .poolSizeCount = kDescriptorPools.size(),
+            .pPoolSizes    = kDescriptorPools.data(),
+        };
+        CHECK(vkCreateDescriptorPool(mDevice, &info, nullptr, &mDescriptorPool));
+    }
+    {// Descriptor Layouts
+        const std::array<VkDescriptorSetLayoutBinding, 1> bindings{
+            VkDescriptorSetLayoutBinding{
+                .binding            = kShaderBindingSceneTexture,
+                .descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .descriptorCount    = 1,
+                .stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT,
+                .pImmutableSamplers = &mUpscaleSampler,
+            },
+        };
+        const VkDescriptorSetLayoutCreateInfo info{
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext         = nullptr,
+            .flags         = 0,
+            .bindingCount  = bindings.size(),
+            .pBindings     = bindings.data(),
+        };
+        CHECK(vkCreateDescriptorSetLayout(mDevice, &info, nullptr, &mUpscaleDescriptorSetLayout));
+    }
     {// Pipeline Layouts
-        const VkPipelineLayoutCreateInfo info{
-            .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-            .pNext                  = nullptr,
-            .flags                  = 0,
-            .setLayoutCount         = 0,
-            .pushConstantRangeCount = 0,
+        {// Scene
+            const VkPipelineLayoutCreateInfo info{
+                .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .pNext                  = nullptr,
+                .flags                  = 0,
+                .setLayoutCount         = 0,
+                .pushConstantRangeCount = 0,
+            };
+            CHECK(vkCreatePipelineLayout(mDevice, &info, nullptr, &mPipelineLayout));
+        }
+        {// Upscale
+            constexpr std::array kConstantRanges{
+                VkPushConstantRange{
+                    .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+                    .offset     = 0,
+                    .size       = sizeof(UpscaleConstants),
+                },
+            };
+            const VkPipelineLayoutCreateInfo info{
+                .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .pNext                  = nullptr,
+                .flags                  = 0,
+                .setLayoutCount         = 1,
+                .pSetLayouts            = &mUpscaleDescriptorSetLayout,
+                .pushConstantRangeCount = kConstantRanges.size(),
+                .pPushConstantRanges    = kConstantRanges.data(),
+            };
+            CHECK(vkCreatePipelineLayout(mDevice, &info, nullptr, &mUpscalePipelineLayout));
+        }
+    }
+    {// Descriptor Set
+        const VkDescriptorSetAllocateInfo info{
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .pNext              = nullptr,
+            .descriptorPool     = mDescriptorPool,
+            .descriptorSetCount = 1,
+            .pSetLayouts        = &mUpscaleDescriptorSetLayout,
         };
-        CHECK(vkCreatePipelineLayout(mDevice, &info, nullptr, &mPipelineLayout));
+        CHECK(vkAllocateDescriptorSets(mDevice, &info, &mUpscaleDescriptorSet));
     }
     initialize_graphic_pipelines();
+    {// Offscreen
+        mOffscreenPipeline.compile(
+            mEngine.mPipelineCompiler,
+            [this, resolution = mResolution]{
+                return create_graphic_pipeline(resolution, true);
+            }
+        );
+        mUpscalePipeline.compile(
+            mEngine.mPipelineCompiler,
+            [this]{
+                return create_upscale_pipeline();
+            }
+        );
+    }
 }
 
 PassScene::~PassScene()
 {
-    vkDestroyPipeline(mDevice, mPipeline, nullptr);
+    vkDestroyFramebuffer(mDevice, mOffscreenFramebuffer, nullptr);
+
+    // NOTE Wait for in-flight compilations, they reference our layout
+    mPipeline.destroy();
+    mOffscreenPipeline.destroy();
+    mUpscalePipeline.destroy();
     vkDestroyPipelineCache(mDevice, mPipelineCache, nullptr);
     vkDestroyPipelineLayout(mDevice, mPipelineLayout, nullptr);
+
+    vkDestroyDescriptorPool(mDevice, mDescriptorPool, nullptr);
+    vkDestroyPipelineLayout(mDevice, mUpscalePipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(mDevice, mUpscaleDescriptorSetLayout, nullptr);
+    vkDestroySampler(mDevice, mUpscaleSampler, nullptr);
 }
 
 void PassScene::initialize_graphic_pipelines()
 {
-    assert(mPipeline == VK_NULL_HANDLE);
+    mPipeline.compile(
+        mEngine.mPipelineCompiler,
+        [this, resolution = mResolution]{
+            return create_graphic_pipeline(resolution, false);
+        }
+    );
+}
 
+VkPipeline PassScene::create_graphic_pipeline(const VkExtent2D& resolution, bool offscreen) const
+{
     VkShaderModule shader = VK_NULL_HANDLE;
 
     {// Shader - UI
@@ -102,8 +329,8 @@ void PassScene::initialize_graphic_pipelines()
     const VkViewport fullviewport{
         .x        = 0.0f,
         .y        = 0.0f,
-        .width    = static_cast<float>(mResolution.width),
-        .height   = static_cast<float>(mResolution.height),
+        .width    = static_cast<float>(resolution.width),
+        .height   = static_cast<float>(resolution.height),
         .minDepth = 0.0f,
         .maxDepth = 1.0f,
     };
@@ -114,8 +341,8 @@ void PassScene::initialize_graphic_pipelines()
             .y = 0,
         },
         .extent = VkExtent2D{
-            .width  = mResolution.width,
-            .height = mResolution.height,
+            .width  = resolution.width,
+            .height = resolution.height,
         }
     };
 
@@ -124,9 +351,9 @@ void PassScene::initialize_graphic_pipelines()
         .pNext         = nullptr,
         .flags         = 0,
         .viewportCount = 1,
-        .pViewports    = &fullviewport,
+        .pViewports    = offscreen ? nullptr : &fullviewport, // dynamic state when offscreen
         .scissorCount  = 1,
-        .pScissors     = &fullscissors,
+        .pScissors     = offscreen ? nullptr : &fullscissors, // dynamic state when offscreen
     };
 
     constexpr VkPipelineRasterizationStateCreateInfo rasterization{
@@ -210,11 +437,17 @@ void PassScene::initialize_graphic_pipelines()
         .blendConstants          = { 0.0f, 0.0f, 0.0f, 0.0f },
     };
 
-    constexpr VkPipelineDynamicStateCreateInfo dynamics{
+    constexpr std::array states{
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
+
+    const/*expr*/ VkPipelineDynamicStateCreateInfo dynamics{
         .sType                   = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
         .pNext                   = nullptr,
         .flags                   = 0,
-        .dynamicStateCount       = 0,
+        .dynamicStateCount       = offscreen ? static_cast<std::uint32_t>(states.size()) : 0u,
+        .pDynamicStates          = offscreen ? states.data() : nullptr,
     };
 
     const VkGraphicsPipelineCreateInfo info{
@@ -229,32 +462,399 @@ void PassScene::initialize_graphic_pipelines()
         .pViewportState      = &viewport,
         .pRasterizationState = &rasterization,
         .pMultisampleState   = &multisample,
-        .pDepthStencilState  = &depthstencil,
+        // NOTE Offscreen render pass has no stencil, the UI is only masked out when upscaling
+        .pDepthStencilState  = offscreen ? nullptr : &depthstencil,
         .pColorBlendState    = &colorblend,
         .pDynamicState       = &dynamics,
         .layout              = mPipelineLayout,
+        .renderPass          = offscreen ? static_cast<VkRenderPass>(mOffscreenRenderPass) : static_cast<VkRenderPass>(mRenderPass),
+        .subpass             = offscreen ? 0 : mSubpass,
+        .basePipelineHandle  = VK_NULL_HANDLE,
+        .basePipelineIndex   = -1,
+    };
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    CHECK(vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &info, nullptr, &pipeline));
+    blk::debug::name(mDevice, pipeline, offscreen ? "Scene Offscreen" : "Scene");
+
+    vkDestroyShaderModule(mDevice, shader, nullptr);
+
+    return pipeline;
+}
+
+VkPipeline PassScene::create_upscale_pipeline() const
+{
+    VkShaderModule shader = VK_NULL_HANDLE;
+
+    {// Shader - Upscale
+        constexpr VkShaderModuleCreateInfo info{
+            .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .pNext    = nullptr,
+            .flags    = 0,
+            .codeSize = kShaderUpscale.size() * sizeof(std::uint32_t),
+            .pCode    = kShaderUpscale.data(),
+        };
+        CHECK(vkCreateShaderModule(mDevice, &info, nullptr, &shader));
+    }
+
+    const std::array stages{
+        VkPipelineShaderStageCreateInfo{
+            .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .pNext               = nullptr,
+            .flags               = 0,
+            .stage               = VK_SHADER_STAGE_VERTEX_BIT,
+            .module              = shader,
+            .pName               = "upscale_main",
+            .pSpecializationInfo = nullptr,
+        },
+        VkPipelineShaderStageCreateInfo{
+            .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .pNext               = nullptr,
+            .flags               = 0,
+            .stage               = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .module              = shader,
+            .pName               = "upscale_main",
+            .pSpecializationInfo = nullptr,
+        },
+    };
+
+    // Fullscreen triangle generated from vertex index
+    constexpr VkPipelineVertexInputStateCreateInfo vertexinput{
+        .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .pNext                           = nullptr,
+        .flags                           = 0,
+        .vertexBindingDescriptionCount   = 0,
+        .pVertexBindingDescriptions      = nullptr,
+        .vertexAttributeDescriptionCount = 0,
+        .pVertexAttributeDescriptions    = nullptr,
+    };
+
+    constexpr VkPipelineInputAssemblyStateCreateInfo assembly{
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .pNext                  = nullptr,
+        .flags                  = 0,
+        .topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        .primitiveRestartEnable = VK_FALSE,
+    };
+
+    constexpr VkPipelineViewportStateCreateInfo viewport{
+        .sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .pNext         = nullptr,
+        .flags         = 0,
+        .viewportCount = 1,
+        .pViewports    = nullptr, // dynamic state
+        .scissorCount  = 1,
+        .pScissors     = nullptr, // dynamic state
+    };
+
+    constexpr VkPipelineRasterizationStateCreateInfo rasterization{
+        .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .pNext                   = nullptr,
+        .flags                   = 0,
+        .depthClampEnable        = VK_FALSE,
+        .rasterizerDiscardEnable = VK_FALSE,
+        .polygonMode             = VK_POLYGON_MODE_FILL,
+        .cullMode                = VK_CULL_MODE_NONE,
+        .frontFace               = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+        .depthBiasEnable         = VK_FALSE,
+        .lineWidth               = 1.0f,
+    };
+
+    constexpr VkPipelineMultisampleStateCreateInfo multisample{
+        .sType                 = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .pNext                 = nullptr,
+        .flags                 = 0,
+        .rasterizationSamples  = VK_SAMPLE_COUNT_1_BIT,
+        .sampleShadingEnable   = VK_FALSE,
+        .minSampleShading      = 0.0f,
+        .pSampleMask           = nullptr,
+        .alphaToCoverageEnable = VK_FALSE,
+        .alphaToOneEnable      = VK_FALSE,
+    };
+
+    // NOTE Same masking as the scene itself, UI pixels are left untouched
+    constexpr VkStencilOpState stencil{
+        .failOp      = VK_STENCIL_OP_KEEP,
+        .passOp      = VK_STENCIL_OP_KEEP,
+        .depthFailOp = VK_STENCIL_OP_KEEP,
+        .compareOp   = VK_COMPARE_OP_NOT_EQUAL,
+        .compareMask = kStencilMask,
+        .writeMask   = 0,
+        .reference   = kStencilReference,
+    };
+
+    constexpr VkPipelineDepthStencilStateCreateInfo depthstencil{
+        .sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .pNext                 = nullptr,
+        .flags                 = 0,
+        .depthTestEnable       = VK_FALSE,
+        .depthWriteEnable      = VK_FALSE,
+        .depthBoundsTestEnable = VK_FALSE,
+        .stencilTestEnable     = VK_TRUE,
+        .front                 = stencil,
+        .back                  = stencil,
+    };
+
+    // NOTE Offscreen image is cleared with the main pass clear color, scene blending already happened there
+    constexpr std::array colorblendattachments{
+        VkPipelineColorBlendAttachmentState{
+            .blendEnable         = VK_FALSE,
+            .colorWriteMask      =
+                VK_COLOR_COMPONENT_R_BIT |
+                VK_COLOR_COMPONENT_G_BIT |
+                VK_COLOR_COMPONENT_B_BIT |
+                VK_COLOR_COMPONENT_A_BIT,
+        }
+    };
+
+    const/*expr*/ VkPipelineColorBlendStateCreateInfo colorblend{
+        .sType                   = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .pNext                   = nullptr,
+        .flags                   = 0,
+        .logicOpEnable           = VK_FALSE,
+        .logicOp                 = VK_LOGIC_OP_CLEAR,
+        .attachmentCount         = colorblendattachments.size(),
+        .pAttachments            = colorblendattachments.data(),
+    };
+
+    constexpr std::array states{
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
+
+    const/*expr*/ VkPipelineDynamicStateCreateInfo dynamics{
+        .sType                   = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .pNext                   = nullptr,
+        .flags                   = 0,
+        .dynamicStateCount       = states.size(),
+        .pDynamicStates          = states.data(),
+    };
+
+    const VkGraphicsPipelineCreateInfo info{
+        .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext               = nullptr,
+        .flags               = 0,
+        .stageCount          = stages.size(),
+        .pStages             = stages.data(),
+        .pVertexInputState   = &vertexinput,
+        .pInputAssemblyState = &assembly,
+        .pTessellationState  = nullptr,
+        .pViewportState      = &viewport,
+        .pRasterizationState = &rasterization,
+        .pMultisampleState   = &multisample,
+        .pDepthStencilState  = &depthstencil,
+        .pColorBlendState    = &colorblend,
+        .pDynamicState       = &dynamics,
+        .layout              = mUpscalePipelineLayout,
         .renderPass          = mRenderPass,
         .subpass             = mSubpass,
         .basePipelineHandle  = VK_NULL_HANDLE,
         .basePipelineIndex   = -1,
     };
 
-    CHECK(vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &info, nullptr, &mPipeline));
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    CHECK(vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &info, nullptr, &pipeline));
+    blk::debug::name(mDevice, pipeline, "Scene Upscale");
 
     vkDestroyShaderModule(mDevice, shader, nullptr);
+
+    return pipeline;
 }
 
 void PassScene::record_pass(VkCommandBuffer commandbuffer)
 {
-    vkCmdBindPipeline(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+    if (mOffscreenActive)
+    {
+        record_upscale(commandbuffer);
+        return;
+    }
+
+    // NOTE While the first compilation is in flight there is nothing to draw with, after a resize the previous pipeline is the fallback
+    VkPipeline pipeline = mPipeline.acquire();
+    if (pipeline == VK_NULL_HANDLE)
+        return;
+
+    vkCmdBindPipeline(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    vkCmdDraw(commandbuffer, 3, 1, 0, 0);
+}
+
+void PassScene::record_upscale(VkCommandBuffer commandbuffer)
+{
+    const VkViewport viewport{
+        .x        = 0.0f,
+        .y        = 0.0f,
+        .width    = static_cast<float>(mResolution.width),
+        .height   = static_cast<float>(mResolution.height),
+        .minDepth = 0.0f,
+        .maxDepth = 1.0f,
+    };
+    const VkRect2D scissor{
+        .offset = VkOffset2D{
+            .x = 0,
+            .y = 0,
+        },
+        .extent = mResolution,
+    };
+
+    vkCmdBindPipeline(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mUpscalePipeline.acquire());
+    vkCmdBindDescriptorSets(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mUpscalePipelineLayout,
+        0,
+        1, &mUpscaleDescriptorSet,
+        0, nullptr
+    );
+    vkCmdSetViewport(commandbuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandbuffer, 0, 1, &scissor);
+    {// Constants
+        UpscaleConstants constants{};
+        constants.scale [0] = static_cast<float>(mRenderExtent.width ) / mResolution.width;
+        constants.scale [1] = static_cast<float>(mRenderExtent.height) / mResolution.height;
+        constants.extent[0] = static_cast<float>(mRenderExtent.width );
+        constants.extent[1] = static_cast<float>(mRenderExtent.height);
+        constants.texel [0] = 1.0f / mOffscreenExtent.width;
+        constants.texel [1] = 1.0f / mOffscreenExtent.height;
+        constants.sharpness = mSharpness;
+        vkCmdPushConstants(commandbuffer, mUpscalePipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(constants), &constants);
+    }
+    // Fullscreen triangle
+    vkCmdDraw(commandbuffer, 3, 1, 0, 0);
+}
+
+void PassScene::recreate_offscreen()
+{
+    // NOTE Latest frame may still use them
+    mEngine.mRetireQueue.retire(
+        [device = static_cast<VkDevice>(mDevice), framebuffer = std::exchange(mOffscreenFramebuffer, VkFramebuffer{VK_NULL_HANDLE})]{
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
+    );
+    mEngine.mRetireQueue.retire_objects(std::move(mOffscreenImageView), std::move(mOffscreenImage), std::move(mOffscreenMemory));
+
+    // NOTE Any scaled extent fits, scale changes do not re-create anything
+    mOffscreenExtent = bucket_extent(mResolution);
+
+    mOffscreenImage = blk::Image(
+        VkExtent3D{ .width = mOffscreenExtent.width, .height = mOffscreenExtent.height, .depth = 1 },
+        VK_IMAGE_TYPE_2D,
+        mOffscreenFormat,
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED
+    );
+    mOffscreenImage.create(mDevice, "Scene Offscreen");
+    {// Memory
+        const auto& vkphysicaldevice = *(mDevice.mPhysicalDevice);
+        auto memory_type = vkphysicaldevice.mMemories.find_compatible(mOffscreenImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        assert(memory_type);
+        mOffscreenMemory = std::make_unique<blk::Memory>(*memory_type, mOffscreenImage.mRequirements.size);
+        mOffscreenMemory->allocate(mDevice, "Scene Offscreen");
+        mOffscreenMemory->bind(mOffscreenImage);
+    }
+    mOffscreenImageView = blk::ImageView(
+        mOffscreenImage,
+        VK_IMAGE_VIEW_TYPE_2D,
+        mOffscreenFormat,
+        VK_IMAGE_ASPECT_COLOR_BIT
+    );
+    mOffscreenImageView.create(mDevice, "Scene Offscreen");
+
+    {// Update DescriptorSet
+        const VkDescriptorImageInfo info{
+            .sampler     = VK_NULL_HANDLE,
+            .imageView   = mOffscreenImageView,
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        };
+        const VkWriteDescriptorSet write{
+            .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext            = nullptr,
+            .dstSet           = mUpscaleDescriptorSet,
+            .dstBinding       = kShaderBindingSceneTexture,
+            .dstArrayElement  = 0,
+            .descriptorCount  = 1,
+            .descriptorType   = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .pImageInfo       = &info,
+            .pBufferInfo      = nullptr,
+            .pTexelBufferView = nullptr,
+        };
+        vkUpdateDescriptorSets(mDevice, 1, &write, 0, nullptr);
+    }
+    {// Framebuffer
+        const VkImageView attachment = mOffscreenImageView;
+        const VkFramebufferCreateInfo info{
+            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .pNext           = nullptr,
+            .flags           = 0u,
+            .renderPass      = mOffscreenRenderPass,
+            .attachmentCount = 1,
+            .pAttachments    = &attachment,
+            .width           = mOffscreenExtent.width,
+            .height          = mOffscreenExtent.height,
+            .layers          = 1,
+        };
+        CHECK(vkCreateFramebuffer(mDevice, &info, nullptr, &mOffscreenFramebuffer));
+    }
+}
+
+bool PassScene::update_offscreen(VkCommandBuffer commandbuffer, const VkClearColorValue& clear_color)
+{
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (mScaler.mEnabled && (mUpscalePipeline.acquire() != VK_NULL_HANDLE))
+        pipeline = mOffscreenPipeline.acquire();
+
+    if (pipeline == VK_NULL_HANDLE)
+    {
+        mRenderExtent    = mResolution;
+        mOffscreenActive = false;
+        return false;
+    }
+
+    // NOTE Offscreen image is only allocated once dynamic resolution is used
+    if (!mOffscreenImage.created() || !same_extent(bucket_extent(mResolution), mOffscreenExtent))
+        recreate_offscreen();
+
+    mRenderExtent = mScaler.scaled(mResolution);
+
+    const VkClearValue clear_value{
+        .color = clear_color,
+    };
+    const VkRect2D area{
+        .offset = VkOffset2D{
+            .x = 0,
+            .y = 0,
+        },
+        .extent = mRenderExtent,
+    };
+    const VkRenderPassBeginInfo info{
+        .sType            = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        .pNext            = nullptr,
+        .renderPass       = mOffscreenRenderPass,
+        .framebuffer      = mOffscreenFramebuffer,
+        .renderArea       = area,
+        .clearValueCount  = 1,
+        .pClearValues     = &clear_value,
+    };
+    const VkViewport viewport{
+        .x        = 0.0f,
+        .y        = 0.0f,
+        .width    = static_cast<float>(mRenderExtent.width),
+        .height   = static_cast<float>(mRenderExtent.height),
+        .minDepth = 0.0f,
+        .maxDepth = 1.0f,
+    };
+    vkCmdBeginRenderPass(commandbuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBindPipeline(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    vkCmdSetViewport(commandbuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandbuffer, 0, 1, &area);
     vkCmdDraw(commandbuffer, 3, 1, 0, 0);
+    vkCmdEndRenderPass(commandbuffer);
+
+    mOffscreenActive = true;
+    return true;
 }
 
 void PassScene::onResize(const VkExtent2D& resolution)
 {
     mResolution = resolution;
-    vkDestroyPipeline(mDevice, mPipeline, nullptr);
-    mPipeline = VK_NULL_HANDLE;
     initialize_graphic_pipelines();
 }
 
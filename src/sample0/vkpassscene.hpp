@@ -6,6 +6,7 @@
 
 #include <chrono>
 #include <vector>
+#include <memory>
 
 #include "./vkdevice.hpp"
 #include "./vkrenderpass.hpp"
@@ -13,12 +14,15 @@
 #include "./vkimage.hpp"
 
 #include "./vkpass.hpp"
+#include "./vkpipelinecompiler.hpp"
+#include "./vkresolutionscaler.hpp"
 
 struct ImGuiContext;
 
 namespace blk
 {
     struct Engine;
+    struct Memory;
 }
 
 namespace blk::sample0
@@ -30,10 +34,21 @@ namespace blk::sample0
         using frame_time_delta_s_t  = std::chrono::duration<float/*, std::seconds*/>;
         using frame_time_delta_ms_t = std::chrono::duration<float, std::milli>;
 
+        // Label of the subpass, see blk::record_subpass
+        static constexpr const char* kName = "Scene";
+
         struct Arguments
         {
             blk::Engine& engine;
             VkExtent2D   resolution;
+            VkFormat     color_format;
+        };
+
+        // Offscreen scene rendering, at a dynamic resolution : color is upscaled by the main pass scene subpass
+        //  Color ends up in a read-only layout
+        struct OffscreenRenderPass : blk::RenderPass
+        {
+            OffscreenRenderPass(const blk::Device& vkdevice, VkFormat formatColor);
         };
 
         // TODO Re-use pipeline cache object, instead of one per pass
@@ -42,7 +57,21 @@ namespace blk::sample0
 
         void initialize_graphic_pipelines();
 
+        // NOTE Called from pipeline compiler worker threads
+        //  Offscreen variant has a dynamic viewport, the rendered extent changes every frame
+        VkPipeline create_graphic_pipeline(const VkExtent2D& resolution, bool offscreen) const;
+        VkPipeline create_upscale_pipeline() const;
+
         void record_pass(VkCommandBuffer commandbuffer) override;
+        void record_upscale(VkCommandBuffer commandbuffer);
+
+        // (Re-)create the offscreen image, allocated for the full resolution rounded up to its extent bucket
+        //  NOTE Previous offscreen objects are retired, see Engine::mRetireQueue
+        void recreate_offscreen();
+        // Render the scene offscreen at the scaled extent if dynamic resolution is enabled, outside of any render pass
+        //  Returns whether the scene subpass upscales it, instead of rendering the scene at full resolution
+        //  NOTE To record once the previous frame completed, the upscale descriptor set is updated in place
+        bool update_offscreen(VkCommandBuffer commandbuffer, const VkClearColorValue& clear_color);
 
         void onResize(const VkExtent2D& resolution);
 
@@ -55,7 +84,32 @@ namespace blk::sample0
 
         VkPipelineCache                      mPipelineCache                = VK_NULL_HANDLE;
 
-        VkPipeline                           mPipeline                     = VK_NULL_HANDLE;
+        blk::AsyncPipeline                   mPipeline;
+
+        // Dynamic Resolution
+        blk::ResolutionScaler                mScaler;
+        // Upscale sharpening strength, 0 for a plain bilinear upscale
+        float                                mSharpness                    = 0.0f;
+        VkFormat                             mOffscreenFormat;
+        // Rounded-up extent the offscreen image is allocated with, see bucket_extent
+        VkExtent2D                           mOffscreenExtent              = {};
+        // Region rendered this frame, i.e. scaled resolution
+        VkExtent2D                           mRenderExtent                 = {};
+        OffscreenRenderPass                  mOffscreenRenderPass;
+        blk::Image                           mOffscreenImage;
+        blk::ImageView                       mOffscreenImageView;
+        std::unique_ptr<blk::Memory>         mOffscreenMemory;
+        VkFramebuffer                        mOffscreenFramebuffer         = VK_NULL_HANDLE;
+        bool                                 mOffscreenActive              = false;
+
+        VkSampler                            mUpscaleSampler               = VK_NULL_HANDLE;
+        VkDescriptorSetLayout                mUpscaleDescriptorSetLayout   = VK_NULL_HANDLE;
+        VkPipelineLayout                     mUpscalePipelineLayout        = VK_NULL_HANDLE;
+        VkDescriptorPool                     mDescriptorPool               = VK_NULL_HANDLE;
+        VkDescriptorSet                      mUpscaleDescriptorSet         = VK_NULL_HANDLE;
+
+        blk::AsyncPipeline                   mOffscreenPipeline;
+        blk::AsyncPipeline                   mUpscalePipeline;
     };
 
 }
@@ -1,36 +1,51 @@
 #include "./vkpassuioverlay.hpp"
+#include "./uivertex.hpp"
+#include "./uidrawcapture.hpp"
+#include "./uiinputcapture.hpp"
 
 #include "../vkutilities.hpp"
 #include "../vkdebug.hpp"
+#include "../vkdebugutils.hpp"
 
 #include "../vkphysicaldevice.hpp"
 #include "../vkengine.hpp"
 
 #include "../vkmemory.hpp"
 #include "../vkqueue.hpp"
+#include "../vkprofiler.hpp"
+#include "../vkperformancewarnings.hpp"
+#include "../vkmemorytracer.hpp"
+#include "../vkstartupprofiler.hpp"
 
 #include "font.hpp"
 #include "ui-shader.hpp"
+#include "composite-shader.hpp"
 
 #include <vulkan/vulkan_core.h>
 
 #include <imgui.h>
+#include <hash.hpp>
 #include <utilities.hpp>
 
 #include <string.h>
 
+#include <cstdio>
 #include <cassert>
 #include <cinttypes>
 
 #include <chrono>
 #include <limits>
+#include <fstream>
 #include <numeric>
 #include <iterator>
 
 #include <array>
 #include <tuple>
+#include <utility>
 #include <vector>
 #include <ranges>
+#include <functional>
+#include <algorithm>
 
 namespace
 {
@@ -39,7 +54,11 @@ namespace
     constexpr std::uint32_t kUIShaderLocationUV           = 1;
     constexpr std::uint32_t kUIShaderLocationColor        = 2;
 
+    constexpr std::uint32_t kUIShaderConstantPositionScale = 0;
+
     constexpr std::uint32_t kShaderBindingFontTexture     = 0;
+    // NOTE Composite shader re-uses the UI descriptor set layout
+    constexpr std::uint32_t kShaderBindingCacheTexture    = 0;
 
     constexpr std::uint32_t kStencilMask                  = 0xFF;
     constexpr std::uint32_t kStencilReference             = 0x01;
@@ -49,6 +68,36 @@ namespace
     constexpr std::size_t kInitialVertexBufferSize = 2 << 20; // 1 Mb
     constexpr std::size_t kInitialIndexBufferSize  = 2 << 20; // 1 Mb
 
+    // Draw list regions get extra room to grow without being relocated (and fully re-uploaded)
+    constexpr std::uint32_t slot_capacity(std::uint32_t count, bool headroom)
+    {
+        return headroom ? count + count / 2 : count;
+    }
+
+    // Font atlas upload, directly from host memory when supported, through a staging buffer otherwise
+    constexpr VkImageUsageFlags font_upload_usage(bool host)
+    {
+        #if defined(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)
+            if (host)
+                return VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+        #endif
+        return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+
+    // NOTE Only frames producing new ImGui draw data are recorded, e.g. none while idle when rendering on demand
+    constexpr const char* kDrawDataCaptureFile = "vkplaygrounds-ui.capture";
+
+    // Keep producing frames for a while after a change, so that ImGui settles (e.g. hovering, popups)
+    constexpr std::chrono::milliseconds kInvalidationSettleDuration(500);
+
+    bool same_rectangle(const VkRect2D& lhs, const VkRect2D& rhs)
+    {
+        return (lhs.offset.x      == rhs.offset.x     )
+            && (lhs.offset.y      == rhs.offset.y     )
+            && (lhs.extent.width  == rhs.extent.width )
+            && (lhs.extent.height == rhs.extent.height);
+    }
+
     struct alignas(4) DearImGuiConstants {
         float scale    [2];
         float translate[2];
@@ -58,6 +107,100 @@ namespace
 namespace blk::sample0
 {
 
+PassUIOverlay::CacheRenderPass::CacheRenderPass(const blk::Device& vkdevice, VkFormat formatColor, VkFormat formatDepth)
+    : blk::RenderPass(vkdevice)
+{
+    // Pass 0 : Draw UI (write stencil, write color)
+    //  Color sampled by the main pass composite
+    //  Stencil loaded by the main pass
+    const std::array attachments{
+        VkAttachmentDescription{
+            .flags          = 0,
+            .format         = formatColor,
+            .samples        = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
+            .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        },
+        VkAttachmentDescription{
+            .flags          = 0,
+            .format         = formatDepth,
+            .samples        = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+        },
+    };
+
+    constexpr std::uint32_t kSubpassUI = 0;
+
+    constexpr std::uint32_t kAttachmentColor = 0;
+    constexpr std::uint32_t kAttachmentDepth = 1;
+
+    constexpr VkAttachmentReference write_color_reference{
+        .attachment = kAttachmentColor,
+        .layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+    };
+    constexpr VkAttachmentReference write_stencil_reference{
+        .attachment = kAttachmentDepth,
+        .layout     = VK_IMAGE_LAYOUT_STENCIL_ATTACHMENT_OPTIMAL,
+    };
+    const/*expr*/ std::array subpasses{
+        VkSubpassDescription{
+            .flags                   = 0,
+            .pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .inputAttachmentCount    = 0,
+            .pInputAttachments       = nullptr,
+            .colorAttachmentCount    = 1,
+            .pColorAttachments       = &write_color_reference,
+            .pResolveAttachments     = nullptr,
+            .pDepthStencilAttachment = &write_stencil_reference,
+            .preserveAttachmentCount = 0,
+            .pPreserveAttachments    = nullptr,
+        },
+    };
+    const/*expr*/ std::array dependencies{
+        // Previous frame composite & stencil test are done before overwriting the cache
+        VkSubpassDependency{
+            .srcSubpass      = VK_SUBPASS_EXTERNAL,
+            .dstSubpass      = kSubpassUI,
+            .srcStageMask    = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            .dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            .srcAccessMask   = 0,
+            .dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .dependencyFlags = 0,
+        },
+        // Cache is visible to the main pass composite & stencil test
+        VkSubpassDependency{
+            .srcSubpass      = kSubpassUI,
+            .dstSubpass      = VK_SUBPASS_EXTERNAL,
+            .srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            .dstStageMask    = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+            .srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+            .dependencyFlags = 0,
+        },
+    };
+    const VkRenderPassCreateInfo info{
+        .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .pNext           = nullptr,
+        .flags           = 0,
+        .attachmentCount = attachments.size(),
+        .pAttachments    = attachments.data(),
+        .subpassCount    = subpasses.size(),
+        .pSubpasses      = subpasses.data(),
+        .dependencyCount = dependencies.size(),
+        .pDependencies   = dependencies.data(),
+    };
+    CHECK(create(info));
+}
+
 PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t subpass, Arguments args)
     : Pass(renderpass, subpass)
     , mEngine(args.engine)
@@ -69,7 +212,17 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
 
     , mVertexBuffer(kInitialVertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
     , mIndexBuffer(kInitialIndexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+
+    , mPipeline(mDevice)
+    , mPackedPipeline(mDevice)
+    , mCachePipeline(mDevice)
+    , mPackedCachePipeline(mDevice)
+    , mCompositePipeline(mDevice)
+
+    , mCacheFormat(args.color_format)
+    , mCacheRenderPass(mDevice, args.color_format, args.depth_format)
 {
+    const blk::StartupPhase phase(kName);
     {// Dear ImGui
         IMGUI_CHECKVERSION();
         {// Style
@@ -88,7 +241,8 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
             io.BackendRendererName = "vkplaygrounds";
             {// Font
                 ImFontConfig config;
-                strncpy_s(config.Name, kFontName, (sizeof(config.Name) / sizeof(config.Name[0])) - 1);
+                // NOTE Truncated and null-terminated, strncpy_s is not portable
+                std::snprintf(config.Name, sizeof(config.Name), "%s", kFontName);
                 config.FontDataOwnedByAtlas = false;
                 io.Fonts->AddFontFromMemoryTTF(
                     const_cast<unsigned char*>(&kFont[0]), sizeof(kFont),
@@ -133,12 +287,12 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
     }
     {// Pools
         {// Descriptor Pools
-            constexpr std::uint32_t kMaxAllocatedSets = 1;
+            constexpr std::uint32_t kMaxAllocatedSets = 3;
             constexpr std::array kDescriptorPools{
-                // 1 sampler : font texture
+                // 3 samplers : font texture, cache texture (x2, see recreate_cache)
                 VkDescriptorPoolSize{
                     .type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                    .descriptorCount = 1,
+                    .descriptorCount = 3,
                 }
             };
             /*constexpr*/static const VkDescriptorPoolCreateInfo info{
@@ -196,17 +350,24 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
         CHECK(vkCreatePipelineLayout(mDevice, &info, nullptr, &mPipelineLayout));
     }
     {// Descriptor Set
+        const std::array layouts{ mDescriptorSetLayout, mDescriptorSetLayout, mDescriptorSetLayout };
         const VkDescriptorSetAllocateInfo info{
             .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
             .pNext              = nullptr,
             .descriptorPool     = mDescriptorPool,
-            .descriptorSetCount = 1,
-            .pSetLayouts        = &mDescriptorSetLayout,
+            .descriptorSetCount = layouts.size(),
+            .pSetLayouts        = layouts.data(),
         };
-        CHECK(vkAllocateDescriptorSets(mDevice, &info, &mDescriptorSet));
+        std::array<VkDescriptorSet, 3> sets{};
+        CHECK(vkAllocateDescriptorSets(mDevice, &info, sets.data()));
+        mDescriptorSet         = sets[0];
+        mCacheDescriptorSets   = { sets[1], sets[2] };
+        mCacheDescriptorSet    = mCacheDescriptorSets[0];
     }
     {// Images
         {// Font
+            mFontHostUpload = mEngine.supports_host_image_copy(VK_FORMAT_R8_UNORM, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
             ImGuiIO& io = ImGui::GetIO();
             {
                 int width = 0, height = 0;
@@ -219,17 +380,18 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
                     VK_FORMAT_R8_UNORM,
                     VK_SAMPLE_COUNT_1_BIT,
                     VK_IMAGE_TILING_OPTIMAL,
-                    VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                    VK_IMAGE_USAGE_SAMPLED_BIT | font_upload_usage(mFontHostUpload),
                     VK_IMAGE_LAYOUT_UNDEFINED
                 );
-                mFontImage.create(mDevice);
+                mFontImage.create(mDevice, "UI Font");
             }
             io.Fonts->SetTexID(&mFontImage);
         }
     }
     {// Buffers
-        mVertexBuffer.create(mDevice);
-        mIndexBuffer.create(mDevice);
+        mVertexBuffer.create(mDevice, "UI Vertices");
+        mIndexBuffer.create(mDevice, "UI Indices");
+        if (!mFontHostUpload)
         {// Font Image Buffer
             ImGuiIO& io = ImGui::GetIO();
 
@@ -238,7 +400,7 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
             io.Fonts->GetTexDataAsAlpha8(&data, &width, &height);
 
             mFontImageStagingBuffer = blk::Buffer(width * height * sizeof(unsigned char), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-            mFontImageStagingBuffer.create(mDevice);
+            mFontImageStagingBuffer.create(mDevice, "UI Font Staging");
         }
     }
     {// Memories
@@ -247,40 +409,44 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
         auto memory_type_index   = vkphysicaldevice.mMemories.find_compatible(mVertexBuffer          , VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
         auto memory_type_vertex  = vkphysicaldevice.mMemories.find_compatible(mIndexBuffer           , VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
         auto memory_type_font    = vkphysicaldevice.mMemories.find_compatible(mFontImage             , 0);
-        auto memory_type_staging = vkphysicaldevice.mMemories.find_compatible(mFontImageStagingBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
         assert(memory_type_index  );
         assert(memory_type_vertex );
         assert(memory_type_font   );
-        assert(memory_type_staging);
 
         if (memory_type_index == memory_type_vertex)
         {
             mGeometryMemory = std::make_unique<blk::Memory>(*memory_type_index, mVertexBuffer.mRequirements.size + mIndexBuffer.mRequirements.size);
-            mGeometryMemory->allocate(mDevice);
+            mGeometryMemory->allocate(mDevice, "UI Geometry");
             mGeometryMemory->bind({ &mVertexBuffer, &mIndexBuffer });
         }
         else
         {
             {
                 mVertexMemory = std::make_unique<blk::Memory>(*memory_type_vertex, mVertexBuffer.mRequirements.size);
-                mVertexMemory->allocate(mDevice);
-                mVertexMemory->bind(mIndexBuffer);
+                mVertexMemory->allocate(mDevice, "UI Vertices");
+                mVertexMemory->bind(mVertexBuffer);
             }
             {
                 mIndexMemory = std::make_unique<blk::Memory>(*memory_type_index, mIndexBuffer.mRequirements.size);
-                mIndexMemory->allocate(mDevice);
+                mIndexMemory->allocate(mDevice, "UI Indices");
                 mIndexMemory->bind(mIndexBuffer);
             }
         }
 
         mFontMemory = std::make_unique<blk::Memory>(*memory_type_font, mFontImage.mRequirements.size);
-        mFontMemory->allocate(mDevice);
+        mFontMemory->allocate(mDevice, "UI Font");
         mFontMemory->bind(mFontImage);
 
-        mStagingMemory = std::make_unique<blk::Memory>(*memory_type_staging, mFontImageStagingBuffer.mRequirements.size);
-        mStagingMemory->allocate(mDevice);
-        mStagingMemory->bind(mFontImageStagingBuffer);
+        if (!mFontHostUpload)
+        {
+            auto memory_type_staging = vkphysicaldevice.mMemories.find_compatible(mFontImageStagingBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            assert(memory_type_staging);
+
+            mStagingMemory = std::make_unique<blk::Memory>(*memory_type_staging, mFontImageStagingBuffer.mRequirements.size);
+            mStagingMemory->allocate(mDevice, "UI Font Staging");
+            mStagingMemory->bind(mFontImageStagingBuffer);
+        }
     }
     {// Image Views
         mFontImageView = blk::ImageView(
@@ -290,7 +456,7 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
                 VK_IMAGE_ASPECT_COLOR_BIT
         );
 
-        mFontImageView.create(mDevice);
+        mFontImageView.create(mDevice, "UI Font");
     }
     {// Update DescriptorSet
         const VkDescriptorImageInfo info{
@@ -374,6 +540,7 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
             }
         }
     }
+    if (!mFontHostUpload)
     {// Command Buffers
         const VkCommandBufferAllocateInfo info{
             .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
@@ -383,7 +550,9 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
             .commandBufferCount = 1,
         };
         CHECK(vkAllocateCommandBuffers(mDevice, &info, &mFontImageStagingCommandBuffer));
+        blk::debug::name(mDevice, mFontImageStagingCommandBuffer, "UI Font Staging");
     }
+    if (!mFontHostUpload)
     {// Fences
         const VkFenceCreateInfo info{
             .sType              = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
@@ -392,6 +561,7 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
         };
         CHECK(vkCreateFence(mDevice, &info, nullptr, &mFontImageStagingFence));
     }
+    if (!mFontHostUpload)
     {// Semaphore
         const VkSemaphoreTypeCreateInfo info_type{
             .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
@@ -408,10 +578,22 @@ PassUIOverlay::PassUIOverlay(const blk::RenderPass& renderpass, std::uint32_t su
     }
     initialize_graphic_pipelines();
 
-    mFrameTick = mStartTick = std::chrono::high_resolution_clock::now();
+    mInvalidationTick = mFrameTick = mStartTick = std::chrono::high_resolution_clock::now();
+
+    if (mFontHostUpload)
+    {// NOTE Image is ready to be sampled, nothing to submit
+        ImGuiIO& io = ImGui::GetIO();
+
+        int width = 0, height = 0;
+        unsigned char* data = nullptr;
+        io.Fonts->GetTexDataAsAlpha8(&data, &width, &height);
 
-    upload_font_image(mFontImageStagingBuffer);
+        mEngine.host_image_upload(mFontImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, data);
+    }
+    else
     {
+        upload_font_image(mFontImageStagingBuffer);
+
         constexpr VkCommandBufferBeginInfo info{
             .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
             .pNext            = nullptr,
@@ -435,7 +617,14 @@ PassUIOverlay::~PassUIOverlay()
     vkDestroyCommandPool(mDevice, mTransferCommandPool, nullptr);
     vkDestroyCommandPool(mDevice, mComputeCommandPool, nullptr);
 
-    vkDestroyPipeline(mDevice, mPipeline, nullptr);
+    vkDestroyFramebuffer(mDevice, mCacheFramebuffer, nullptr);
+
+    // NOTE Wait for in-flight compilations, they reference our layout
+    mPipeline.destroy();
+    mPackedPipeline.destroy();
+    mCachePipeline.destroy();
+    mPackedCachePipeline.destroy();
+    mCompositePipeline.destroy();
 
     vkDestroyDescriptorPool(mDevice, mDescriptorPool, nullptr);
 
@@ -450,8 +639,40 @@ PassUIOverlay::~PassUIOverlay()
 
 void PassUIOverlay::initialize_graphic_pipelines()
 {
-    assert(mPipeline == VK_NULL_HANDLE);
+    mPipeline.compile(
+        mEngine.mPipelineCompiler,
+        [this]{
+            return create_graphic_pipeline(false, mRenderPass, mSubpass);
+        }
+    );
+    mPackedPipeline.compile(
+        mEngine.mPipelineCompiler,
+        [this]{
+            return create_graphic_pipeline(true, mRenderPass, mSubpass);
+        }
+    );
+    mCachePipeline.compile(
+        mEngine.mPipelineCompiler,
+        [this]{
+            return create_graphic_pipeline(false, mCacheRenderPass, 0);
+        }
+    );
+    mPackedCachePipeline.compile(
+        mEngine.mPipelineCompiler,
+        [this]{
+            return create_graphic_pipeline(true, mCacheRenderPass, 0);
+        }
+    );
+    mCompositePipeline.compile(
+        mEngine.mPipelineCompiler,
+        [this]{
+            return create_composite_pipeline();
+        }
+    );
+}
 
+VkPipeline PassUIOverlay::create_graphic_pipeline(bool packed, VkRenderPass renderpass, std::uint32_t subpass) const
+{
     VkShaderModule shader = VK_NULL_HANDLE;
 
     {// Shader - UI
@@ -465,6 +686,22 @@ void PassUIOverlay::initialize_graphic_pipelines()
         CHECK(vkCreateShaderModule(mDevice, &info, nullptr, &shader));
     }
 
+    // NOTE Packed positions are stored as SNORM (mandatory vertex format support, unlike SSCALED), scaled back into fixed point pixels
+    const float position_scale = packed ? (32767.0f / kPackedPositionScale) : 1.0f;
+
+    constexpr VkSpecializationMapEntry specializationentry{
+        .constantID = kUIShaderConstantPositionScale,
+        .offset     = 0,
+        .size       = sizeof(float),
+    };
+
+    const VkSpecializationInfo specialization{
+        .mapEntryCount = 1,
+        .pMapEntries   = &specializationentry,
+        .dataSize      = sizeof(float),
+        .pData         = &position_scale,
+    };
+
     const std::array stages{
         VkPipelineShaderStageCreateInfo{
             .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -473,7 +710,7 @@ void PassUIOverlay::initialize_graphic_pipelines()
             .stage               = VK_SHADER_STAGE_VERTEX_BIT,
             .module              = shader,
             .pName               = "ui_main",
-            .pSpecializationInfo = nullptr,
+            .pSpecializationInfo = &specialization,
         },
         VkPipelineShaderStageCreateInfo{
             .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -486,11 +723,11 @@ void PassUIOverlay::initialize_graphic_pipelines()
         },
     };
 
-    constexpr std::array vertexbindings{
+    const std::array vertexbindings{
         VkVertexInputBindingDescription
         {
             .binding   = kVertexInputBindingPosUVColor,
-            .stride    = sizeof(ImDrawVert),
+            .stride    = static_cast<std::uint32_t>(packed ? sizeof(PackedVertex) : sizeof(ImDrawVert)),
             .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
         }
     };
@@ -516,14 +753,36 @@ void PassUIOverlay::initialize_graphic_pipelines()
         },
     };
 
-    static const/*expr*/ VkPipelineVertexInputStateCreateInfo vertexinput{
+    constexpr std::array packedvertexattributes{
+        VkVertexInputAttributeDescription{
+            .location = kUIShaderLocationPos,
+            .binding  = kVertexInputBindingPosUVColor,
+            .format   = VK_FORMAT_R16G16_SNORM,
+            .offset   = offsetof(PackedVertex, pos),
+        },
+        VkVertexInputAttributeDescription{
+            .location = kUIShaderLocationUV,
+            .binding  = kVertexInputBindingPosUVColor,
+            .format   = VK_FORMAT_R16G16_UNORM,
+            .offset   = offsetof(PackedVertex, uv),
+        },
+        VkVertexInputAttributeDescription{
+            .location = kUIShaderLocationColor,
+            .binding  = kVertexInputBindingPosUVColor,
+            .format   = VK_FORMAT_R8G8B8A8_UNORM,
+            .offset   = offsetof(PackedVertex, col),
+        },
+    };
+    static_assert(vertexattributes.size() == packedvertexattributes.size());
+
+    const/*expr*/ VkPipelineVertexInputStateCreateInfo vertexinput{
         .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .pNext                           = nullptr,
         .flags                           = 0,
         .vertexBindingDescriptionCount   = vertexbindings.size(),
         .pVertexBindingDescriptions      = vertexbindings.data(),
         .vertexAttributeDescriptionCount = vertexattributes.size(),
-        .pVertexAttributeDescriptions    = vertexattributes.data(),
+        .pVertexAttributeDescriptions    = packed ? packedvertexattributes.data() : vertexattributes.data(),
     };
 
     constexpr VkPipelineInputAssemblyStateCreateInfo assembly{
@@ -608,7 +867,185 @@ void PassUIOverlay::initialize_graphic_pipelines()
         }
     };
 
-    static const/*expr*/ VkPipelineColorBlendStateCreateInfo colorblend{
+    const/*expr*/ VkPipelineColorBlendStateCreateInfo colorblend{
+        .sType                   = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .pNext                   = nullptr,
+        .flags                   = 0,
+        .logicOpEnable           = VK_FALSE,
+        .logicOp                 = VK_LOGIC_OP_CLEAR,
+        .attachmentCount         = colorblendattachments.size(),
+        .pAttachments            = colorblendattachments.data(),
+    };
+
+    constexpr std::array states{
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
+
+    const/*expr*/ VkPipelineDynamicStateCreateInfo dynamics{
+        .sType                   = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .pNext                   = nullptr,
+        .flags                   = 0,
+        .dynamicStateCount       = states.size(),
+        .pDynamicStates          = states.data(),
+    };
+
+    const VkGraphicsPipelineCreateInfo info{
+        .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext               = nullptr,
+        .flags               = 0,
+        .stageCount          = stages.size(),
+        .pStages             = stages.data(),
+        .pVertexInputState   = &vertexinput,
+        .pInputAssemblyState = &assembly,
+        .pTessellationState  = nullptr,
+        .pViewportState      = &viewport,
+        .pRasterizationState = &rasterization,
+        .pMultisampleState   = &multisample,
+        .pDepthStencilState  = &depthstencil,
+        .pColorBlendState    = &colorblend,
+        .pDynamicState       = &dynamics,
+        .layout              = mPipelineLayout,
+        .renderPass          = renderpass,
+        .subpass             = subpass,
+        .basePipelineHandle  = VK_NULL_HANDLE,
+        .basePipelineIndex   = -1,
+    };
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    CHECK(vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &info, nullptr, &pipeline));
+    blk::debug::name(mDevice, pipeline, packed ? "UI Packed" : "UI");
+
+    vkDestroyShaderModule(mDevice, shader, nullptr);
+
+    return pipeline;
+}
+
+VkPipeline PassUIOverlay::create_composite_pipeline() const
+{
+    VkShaderModule shader = VK_NULL_HANDLE;
+
+    {// Shader - Composite
+        constexpr VkShaderModuleCreateInfo info{
+            .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .pNext    = nullptr,
+            .flags    = 0,
+            .codeSize = kShaderComposite.size() * sizeof(std::uint32_t),
+            .pCode    = kShaderComposite.data(),
+        };
+        CHECK(vkCreateShaderModule(mDevice, &info, nullptr, &shader));
+    }
+
+    const std::array stages{
+        VkPipelineShaderStageCreateInfo{
+            .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .pNext               = nullptr,
+            .flags               = 0,
+            .stage               = VK_SHADER_STAGE_VERTEX_BIT,
+            .module              = shader,
+            .pName               = "composite_main",
+            .pSpecializationInfo = nullptr,
+        },
+        VkPipelineShaderStageCreateInfo{
+            .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .pNext               = nullptr,
+            .flags               = 0,
+            .stage               = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .module              = shader,
+            .pName               = "composite_main",
+            .pSpecializationInfo = nullptr,
+        },
+    };
+
+    // Fullscreen triangle generated from vertex index
+    constexpr VkPipelineVertexInputStateCreateInfo vertexinput{
+        .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .pNext                           = nullptr,
+        .flags                           = 0,
+        .vertexBindingDescriptionCount   = 0,
+        .pVertexBindingDescriptions      = nullptr,
+        .vertexAttributeDescriptionCount = 0,
+        .pVertexAttributeDescriptions    = nullptr,
+    };
+
+    constexpr VkPipelineInputAssemblyStateCreateInfo assembly{
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .pNext                  = nullptr,
+        .flags                  = 0,
+        .topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        .primitiveRestartEnable = VK_FALSE,
+    };
+
+    constexpr VkPipelineViewportStateCreateInfo viewport{
+        .sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .pNext         = nullptr,
+        .flags         = 0,
+        .viewportCount = 1,
+        .pViewports    = nullptr, // dynamic state
+        .scissorCount  = 1,
+        .pScissors     = nullptr, // dynamic state
+    };
+
+    constexpr VkPipelineRasterizationStateCreateInfo rasterization{
+        .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .pNext                   = nullptr,
+        .flags                   = 0,
+        .depthClampEnable        = VK_FALSE,
+        .rasterizerDiscardEnable = VK_FALSE,
+        .polygonMode             = VK_POLYGON_MODE_FILL,
+        .cullMode                = VK_CULL_MODE_NONE,
+        .frontFace               = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+        .depthBiasEnable         = VK_FALSE,
+        .lineWidth               = 1.0f,
+    };
+
+    constexpr VkPipelineMultisampleStateCreateInfo multisample{
+        .sType                 = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .pNext                 = nullptr,
+        .flags                 = 0,
+        .rasterizationSamples  = VK_SAMPLE_COUNT_1_BIT,
+        .sampleShadingEnable   = VK_FALSE,
+        .minSampleShading      = 0.0f,
+        .pSampleMask           = nullptr,
+        .alphaToCoverageEnable = VK_FALSE,
+        .alphaToOneEnable      = VK_FALSE,
+    };
+
+    // NOTE Only UI pixels of the cached stencil are composited, stencil is left untouched for the scene pass
+    constexpr VkStencilOpState stencil{
+        .failOp      = VK_STENCIL_OP_KEEP,
+        .passOp      = VK_STENCIL_OP_KEEP,
+        .depthFailOp = VK_STENCIL_OP_KEEP,
+        .compareOp   = VK_COMPARE_OP_EQUAL,
+        .compareMask = kStencilMask,
+        .writeMask   = 0,
+        .reference   = kStencilReference,
+    };
+
+    constexpr VkPipelineDepthStencilStateCreateInfo depthstencil{
+        .sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .pNext                 = nullptr,
+        .flags                 = 0,
+        .depthTestEnable       = VK_FALSE,
+        .depthWriteEnable      = VK_FALSE,
+        .depthBoundsTestEnable = VK_FALSE,
+        .stencilTestEnable     = VK_TRUE,
+        .front                 = stencil,
+        .back                  = stencil,
+    };
+
+    constexpr std::array colorblendattachments{
+        VkPipelineColorBlendAttachmentState{
+            .blendEnable         = VK_FALSE,
+            .colorWriteMask      =
+                VK_COLOR_COMPONENT_R_BIT |
+                VK_COLOR_COMPONENT_G_BIT |
+                VK_COLOR_COMPONENT_B_BIT |
+                VK_COLOR_COMPONENT_A_BIT,
+        }
+    };
+
+    const/*expr*/ VkPipelineColorBlendStateCreateInfo colorblend{
         .sType                   = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
         .pNext                   = nullptr,
         .flags                   = 0,
@@ -623,7 +1060,7 @@ void PassUIOverlay::initialize_graphic_pipelines()
         VK_DYNAMIC_STATE_SCISSOR,
     };
 
-    static const/*expr*/ VkPipelineDynamicStateCreateInfo dynamics{
+    const/*expr*/ VkPipelineDynamicStateCreateInfo dynamics{
         .sType                   = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
         .pNext                   = nullptr,
         .flags                   = 0,
@@ -653,19 +1090,84 @@ void PassUIOverlay::initialize_graphic_pipelines()
         .basePipelineIndex   = -1,
     };
 
-    CHECK(vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &info, nullptr, &mPipeline));
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    CHECK(vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &info, nullptr, &pipeline));
+    blk::debug::name(mDevice, pipeline, "UI Composite");
 
     vkDestroyShaderModule(mDevice, shader, nullptr);
+
+    return pipeline;
+}
+
+bool PassUIOverlay::need_imgui_frame() const
+{
+    // Animated widgets
+    if (mUI.show_gpu_information || mUI.show_demo || mUI.show_profiler || mUI.show_performance_warnings)
+        return true;
+
+    // One frame per recorded frame
+    if (mInputReplay && !mInputReplay->finished())
+        return true;
+
+    if (mMouse != mFedMouse)
+        return true;
+
+    // Nothing to draw with yet
+    if (mPipeline.pending() || mPackedPipeline.pending())
+        return true;
+
+    if (mUI.cache_ui && (mCachePipeline.pending() || mPackedCachePipeline.pending() || mCompositePipeline.pending()))
+        return true;
+
+    return (std::chrono::high_resolution_clock::now() - mInvalidationTick) < kInvalidationSettleDuration;
+}
+
+void PassUIOverlay::invalidate()
+{
+    mInvalidationTick = std::chrono::high_resolution_clock::now();
 }
 
 void PassUIOverlay::render_imgui_frame()
 {
+    BLK_PROFILE_ZONE("PassUIOverlay::render_imgui_frame");
     auto previous_frame_tick = std::exchange(mFrameTick, std::chrono::high_resolution_clock::now());
     {
         {// ImGui
             ImGuiIO& io = ImGui::GetIO();
             io.DeltaTime = frame_time_delta_ms_t(mFrameTick - previous_frame_tick).count();
 
+            // NOTE Recorded input only replays identically from the default layout, imgui.ini is neither loaded (first NewFrame) nor saved
+            if (mInputRecorder || mInputReplay)
+                io.IniFilename = nullptr;
+
+            if (mInputReplay && !mInputReplay->finished())
+            {// Input Replay, live input is discarded
+                const InputFrame& frame = mInputReplay->next();
+                mMouse.offset.x       = frame.mouse[0];
+                mMouse.offset.y       = frame.mouse[1];
+                mMouse.wheel.vdelta   = frame.wheel[0];
+                mMouse.wheel.hdelta   = frame.wheel[1];
+                mMouse.buttons.left   = (frame.buttons & InputFrame::kButtonLeft  ) != 0;
+                mMouse.buttons.right  = (frame.buttons & InputFrame::kButtonRight ) != 0;
+                mMouse.buttons.middle = (frame.buttons & InputFrame::kButtonMiddle) != 0;
+                io.DeltaTime = mFixedTimestep.count();
+            }
+            if (mInputRecorder)
+            {// Input Recording
+                mInputRecorder->record(InputFrame{
+                    .timestamp = 0,
+                    .delta     = io.DeltaTime,
+                    .mouse     = { mMouse.offset.x, mMouse.offset.y },
+                    .wheel     = { mMouse.wheel.vdelta, mMouse.wheel.hdelta },
+                    .buttons   = (mMouse.buttons.left   ? InputFrame::kButtonLeft   : 0u)
+                               | (mMouse.buttons.right  ? InputFrame::kButtonRight  : 0u)
+                               | (mMouse.buttons.middle ? InputFrame::kButtonMiddle : 0u),
+                });
+            }
+
+            if (mMouse != mFedMouse)
+                invalidate();
+
             io.MousePos                           = ImVec2(mMouse.offset.x, mMouse.offset.y);
             io.MouseDown[ImGuiMouseButton_Left  ] = mMouse.buttons.left;
             io.MouseDown[ImGuiMouseButton_Right ] = mMouse.buttons.right;
@@ -673,14 +1175,53 @@ void PassUIOverlay::render_imgui_frame()
             io.MouseWheel                         = mMouse.wheel.vdelta;
             io.MouseWheelH                        = mMouse.wheel.hdelta;
 
+            // NOTE Wheel deltas are accumulated between frames, consume them
+            mMouse.wheel = {};
+            mFedMouse = mMouse;
+
             ImGui::NewFrame();
             {// Window
                 if (ImGui::BeginMainMenuBar())
                 {
+                    if (ImGui::BeginMenu("Options"))
+                    {
+                        ImGui::MenuItem("Render On Demand", "", &mUI.render_on_demand);
+                        ImGui::MenuItem("Packed Vertices", "", &mUI.packed_vertices);
+                        ImGui::MenuItem("Cache UI", "", &mUI.cache_ui);
+                        ImGui::MenuItem("Record UI Draw Data", "", &mUI.record_draw_data);
+                        if (ImGui::BeginMenu("Presentation"))
+                        {
+                            for (auto&& policy : blk::kPresentPolicies)
+                            {
+                                if (ImGui::MenuItem(blk::PresentPolicy2Text(policy), "", mUI.present_policy == policy))
+                                {
+                                    mUI.present_policy_changed = mUI.present_policy_changed || (mUI.present_policy != policy);
+                                    mUI.present_policy = policy;
+                                }
+                            }
+                            ImGui::Separator();
+                            // NOTE 0 means unbounded
+                            ImGui::SliderFloat("Frame Interval", &mUI.target_frame_interval, 0.0f, 100.0f, "%.1f ms");
+                            ImGui::MenuItem("Just-In-Time Frame Start", "", &mUI.jit_frame_start);
+                            ImGui::EndMenu();
+                        }
+                        if (ImGui::BeginMenu("Scene"))
+                        {
+                            ImGui::MenuItem("Dynamic Resolution", "", &mUI.dynamic_resolution, mUI.gpu_timestamps);
+                            ImGui::SliderFloat("Target GPU Time", &mUI.target_gpu_time, 1.0f, 50.0f, "%.1f ms");
+                            // NOTE 0 means a plain bilinear upscale
+                            ImGui::SliderFloat("Upscale Sharpness", &mUI.upscale_sharpness, 0.0f, 1.0f, "%.2f");
+                            ImGui::EndMenu();
+                        }
+                        ImGui::EndMenu();
+                    }
                     if (ImGui::BeginMenu("About"))
                     {
                         ImGui::MenuItem("GPU Information", "", &mUI.show_gpu_information);
                         ImGui::MenuItem("Show Demos", "", &mUI.show_demo);
+                        ImGui::MenuItem("CPU Profiler", "", &mUI.show_profiler);
+                        ImGui::MenuItem("Performance Warnings", "", &mUI.show_performance_warnings);
+                        ImGui::MenuItem("Device Memory", "", &mUI.show_memory);
                         ImGui::EndMenu();
                     }
                     ImGui::EndMainMenuBar();
@@ -693,6 +1234,23 @@ void PassUIOverlay::render_imgui_frame()
                     ImGui::Begin("GPU Information");
 
                     ImGui::TextUnformatted(mDevice.mPhysicalDevice->mProperties.deviceName);
+                    ImGui::Text("Present Mode: %s (%s)", PresentMode2Text(mUI.present_mode), blk::PresentPolicy2Text(mUI.present_policy));
+                    ImGui::Text(
+                        "Frame Pacing (%s): %.2f ms (jitter %.2f ms, %.2f - %.2f ms)",
+                        mUI.pacing_present_wait ? "present wait" : "fence",
+                        mUI.pacing_mean,
+                        mUI.pacing_jitter,
+                        mUI.pacing_min,
+                        mUI.pacing_max
+                    );
+                    ImGui::Text(
+                        "Input Latency (%s): %.2f ms (CPU %.2f ms, GPU %.2f ms, sleep %.2f ms)",
+                        mUI.latency_measured ? "measured" : "estimated",
+                        mUI.latency,
+                        mUI.latency_cpu,
+                        mUI.latency_gpu,
+                        mUI.latency_sleep
+                    );
 
                     // TODO Do it outside ImGui frame
                     // Update frame time display
@@ -725,110 +1283,616 @@ void PassUIOverlay::render_imgui_frame()
                         ImVec2(0, 80)
                     );
 
+                    ImGui::Text(
+                        "UI Draws: %u / %u commands, %u scissors",
+                        mDrawStatistics.draws,
+                        mDrawStatistics.commands,
+                        mDrawStatistics.scissors
+                    );
+                    ImGui::Text(
+                        "UI Upload: %llu / %llu bytes",
+                        static_cast<unsigned long long>(mUploadStatistics.uploaded),
+                        static_cast<unsigned long long>(mUploadStatistics.total)
+                    );
+                    if (mUI.cache_ui)
+                        ImGui::Text("UI Cache: %u updates", mCacheUpdates);
+                    if (mUI.gpu_timestamps)
+                        ImGui::Text(
+                            "GPU Time: %.2f ms, scene at %u x %u (%.0f%%)",
+                            mUI.gpu_time,
+                            mUI.scene_extent.width,
+                            mUI.scene_extent.height,
+                            (mResolution.width > 0) ? (100.0f * mUI.scene_extent.width / mResolution.width) : 0.0f
+                        );
+                    if (mUI.pipeline_statistics && ImGui::CollapsingHeader("Pipeline Statistics"))
+                    {
+                        // NOTE Fragment invocations per pixel approximates overdraw (helper invocations included)
+                        const double pixels = std::max(static_cast<double>(mResolution.width) * mResolution.height, 1.0);
+                        ImGui::Columns(7, "pipeline_statistics");
+                        for (auto&& header : { "Pass", "IA Vertices", "IA Primitives", "VS Invocations", "Clip Primitives", "FS Invocations", "FS / Pixel" })
+                        {
+                            ImGui::TextUnformatted(header);
+                            ImGui::NextColumn();
+                        }
+                        ImGui::Separator();
+                        for (auto&& [name, statistics] : mUI.pass_statistics)
+                        {
+                            ImGui::TextUnformatted(name);
+                            ImGui::NextColumn();
+                            for (auto&& counter : {
+                                statistics.input_assembly_vertices,
+                                statistics.input_assembly_primitives,
+                                statistics.vertex_shader_invocations,
+                                statistics.clipping_primitives,
+                                statistics.fragment_shader_invocations,
+                            })
+                            {
+                                ImGui::Text("%llu", static_cast<unsigned long long>(counter));
+                                ImGui::NextColumn();
+                            }
+                            ImGui::Text("%.2f", statistics.fragment_shader_invocations / pixels);
+                            ImGui::NextColumn();
+                        }
+                        ImGui::Columns(1);
+                    }
+
                     ImGui::End();
                 }
             }
+            if (mUI.show_profiler)
+                render_profiler_window();
+            if (mUI.show_performance_warnings)
+                render_performance_warnings_window();
+            if (mUI.show_memory)
+                render_memory_window();
             if (mUI.show_demo)
             {// Demo Window
                 ImGui::SetNextWindowPos(ImVec2(650, 20), ImGuiCond_FirstUseEver);
                 ImGui::ShowDemoWindow();
             }
             ImGui::Render();
+            optimize_imgui_draw_data();
+
+            {// Draw Data Capture
+                if (!mUI.record_draw_data)
+                    mDrawDataRecorder.reset();
+                else if (!mDrawDataRecorder)
+                    mDrawDataRecorder = std::make_unique<DrawDataRecorder>(kDrawDataCaptureFile);
+
+                if (mDrawDataRecorder)
+                    mDrawDataRecorder->record(*ImGui::GetDrawData());
+            }
+
+            // e.g. blinking text cursor
+            if (io.WantTextInput)
+                invalidate();
         }
     }
 }
 
-void PassUIOverlay::upload_imgui_draw_data()
+void PassUIOverlay::render_profiler_window()
 {
-    const ImDrawData* data = ImGui::GetDrawData();
-    assert(data);
-    assert(data->Valid);
+    using blk::profiler::Profiler;
+    using blk::profiler::Record;
 
-    if (data->TotalVtxCount != 0)
+    constexpr const char* kTraceFile = "vkplaygrounds-trace.json";
+
+    ImGui::SetNextWindowSize(ImVec2(600, 200), ImGuiCond_FirstUseEver);
+    ImGui::Begin("CPU Profiler", &mUI.show_profiler);
+    if (!blk::profiler::kEnabled)
     {
-        // TODO Check Alignment
-        const VkDeviceSize vertexsize = data->TotalVtxCount * sizeof(ImDrawVert);
-        const VkDeviceSize indexsize  = data->TotalIdxCount * sizeof(ImDrawIdx);
+        ImGui::TextUnformatted("Zones are compiled out, see ENABLE_PROFILING");
+        ImGui::End();
+        return;
+    }
 
-        assert(vertexsize <= mVertexBuffer.mRequirements.size);
-        assert(indexsize  <= mIndexBuffer .mRequirements.size);
+    Profiler& profiler = Profiler::instance();
+    const std::uint64_t frame_duration = std::max<std::uint64_t>(profiler.mFrameEnd - profiler.mFrameBegin, 1);
+    ImGui::Text(
+        "Frame: %.2f ms, %zu zones, %llu dropped",
+        frame_duration * 1e-6,
+        profiler.mFrame.size(),
+        static_cast<unsigned long long>(profiler.mDropped)
+    );
+    ImGui::SameLine();
+    if (ImGui::Button("Export Trace"))
+    {
+        // NOTE Every zone kept, not only the latest frame
+        std::ofstream stream(kTraceFile);
+        profiler.export_chrome_trace(stream);
+    }
 
-        ImDrawVert* address_vertex = nullptr;
-        ImDrawIdx*  address_index = nullptr;
-        if (mVertexBuffer.mMemory != mIndexBuffer.mMemory)
+    {// Flame view, one lane per thread, one row per zone depth
+        ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        const ImVec2 origin     = ImGui::GetCursorScreenPos();
+        const float  width      = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+        const float  row_height = ImGui::GetTextLineHeightWithSpacing();
+        const float  scale      = width / static_cast<float>(frame_duration);
+
+        float lane_y = origin.y;
+        for (auto lane_begin = std::begin(profiler.mFrame); lane_begin != std::end(profiler.mFrame);)
         {
-            CHECK(vkMapMemory(
-                mDevice,
-                *mVertexBuffer.mMemory,
-                mVertexBuffer.mOffset,
-                vertexsize,
-                0,
-                reinterpret_cast<void**>(&address_vertex)
-            ));
-            CHECK(vkMapMemory(
-                mDevice,
-                *mIndexBuffer.mMemory,
-                mIndexBuffer.mOffset,
-                indexsize,
-                0,
-                reinterpret_cast<void**>(&address_index)
-            ));
-            for(auto idx = 0, count = data->CmdListsCount; idx < count; ++idx)
+            const std::uint32_t thread = lane_begin->thread;
+            const auto lane_end = std::find_if(lane_begin, std::end(profiler.mFrame), [thread](const Record& record) {
+                return record.thread != thread;
+            });
+
+            std::uint32_t depth_max = 0;
+            for (auto&& record : std::ranges::subrange(lane_begin, lane_end))
             {
-                const ImDrawList* list = data->CmdLists[idx];
-                std::copy(list->VtxBuffer.Data, std::next(list->VtxBuffer.Data, list->VtxBuffer.Size), address_vertex);
-                std::copy(list->IdxBuffer.Data, std::next(list->IdxBuffer.Data, list->IdxBuffer.Size), address_index);
-                address_vertex += list->VtxBuffer.Size;
-                address_index  += list->IdxBuffer.Size;
+                depth_max = std::max(depth_max, record.zone.depth);
+
+                // NOTE Clamped to the frame, e.g. GPU ranges submitted by the previous frame
+                const float x0 = origin.x + (std::max(record.zone.begin, profiler.mFrameBegin) - profiler.mFrameBegin) * scale;
+                const float x1 = std::max(x0 + 1.0f, origin.x + (std::min(record.zone.end, profiler.mFrameEnd) - profiler.mFrameBegin) * scale);
+                const float y0 = lane_y + record.zone.depth * row_height;
+                const float y1 = y0 + row_height - 1.0f;
+
+                // NOTE Names are string literals, their address is a stable color key
+                const std::size_t key = std::hash<const char*>{}(record.zone.name);
+                const ImU32 color = IM_COL32(64 + (key & 0x7F), 64 + ((key >> 7) & 0x7F), 64 + ((key >> 14) & 0x7F), 255);
+                draw_list->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), color);
+                draw_list->PushClipRect(ImVec2(x0, y0), ImVec2(x1, y1), true);
+                draw_list->AddText(ImVec2(x0 + 2.0f, y0), IM_COL32_WHITE, record.zone.name);
+                draw_list->PopClipRect();
+
+                if (ImGui::IsMouseHoveringRect(ImVec2(x0, y0), ImVec2(x1, y1)))
+                    ImGui::SetTooltip("%s: %.3f ms", record.zone.name, (record.zone.end - record.zone.begin) * 1e-6);
             }
-            vkUnmapMemory(mDevice, *mIndexBuffer.mMemory);
-            vkUnmapMemory(mDevice, *mVertexBuffer.mMemory);
+
+            lane_y += (depth_max + 1) * row_height + ImGui::GetStyle().ItemSpacing.y;
+            lane_begin = lane_end;
         }
+        ImGui::Dummy(ImVec2(width, lane_y - origin.y));
+    }
+
+    ImGui::End();
+}
+
+void PassUIOverlay::render_performance_warnings_window()
+{
+    using Warning = blk::PerformanceWarnings::Warning;
+
+    constexpr std::array kColumns{ "Message", "Count", "Frame", "Last Frame", "Objects" };
+
+    ImGui::SetNextWindowSize(ImVec2(700, 200), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Performance Warnings", &mUI.show_performance_warnings);
+
+    std::vector<Warning> warnings = blk::PerformanceWarnings::instance().warnings();
+    if (warnings.empty())
+    {
+        ImGui::TextUnformatted("No performance message, best practices checks are enabled with --best-practices");
+        ImGui::End();
+        return;
+    }
+
+    {// Sort
+        const auto less = [column = mUI.performance_warnings_sort](const Warning& lhs, const Warning& rhs) {
+            switch (column)
+            {
+                case 1 : return lhs.count       < rhs.count;
+                case 2 : return lhs.frame_count < rhs.frame_count;
+                case 3 : return lhs.last_frame  < rhs.last_frame;
+                case 4 : return lhs.objects.size() < rhs.objects.size();
+                default: return lhs.name < rhs.name;
+            }
+        };
+        if (mUI.performance_warnings_ascending)
+            std::ranges::stable_sort(warnings, less);
         else
+            std::ranges::stable_sort(warnings, [&less](const Warning& lhs, const Warning& rhs) { return less(rhs, lhs); });
+    }
+
+    ImGui::Columns(static_cast<int>(kColumns.size()), "performance_warnings");
+    for (int column = 0; column < static_cast<int>(kColumns.size()); ++column)
+    {
+        // NOTE Clicking the sorted column flips the order
+        const bool sorted = (column == mUI.performance_warnings_sort);
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s%s", kColumns[column], sorted ? (mUI.performance_warnings_ascending ? " (+)" : " (-)") : "");
+        if (ImGui::Selectable(label, sorted))
         {
-            {// Vertex
-                CHECK(vkMapMemory(
-                    mDevice,
-                    *mVertexBuffer.mMemory,
-                    mVertexBuffer.mOffset,
-                    vertexsize,
-                    0,
-                    reinterpret_cast<void**>(&address_vertex)
-                ));
-                for(auto idx = 0, count = data->CmdListsCount; idx < count; ++idx)
-                {
-                    const ImDrawList* list = data->CmdLists[idx];
-                    std::copy(list->VtxBuffer.Data, std::next(list->VtxBuffer.Data, list->VtxBuffer.Size), address_vertex);
-                    address_vertex += list->VtxBuffer.Size;
-                }
-                vkUnmapMemory(mDevice, *mVertexBuffer.mMemory);
+            mUI.performance_warnings_ascending = sorted ? !mUI.performance_warnings_ascending : false;
+            mUI.performance_warnings_sort      = column;
+        }
+        ImGui::NextColumn();
+    }
+    ImGui::Separator();
+    for (auto&& warning : warnings)
+    {
+        ImGui::TextUnformatted(warning.name.empty() ? "(unnamed)" : warning.name.c_str());
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::BeginTooltip();
+            ImGui::PushTextWrapPos(ImGui::GetFontSize() * 40.0f);
+            ImGui::Text("%s (%d)", VkDebugUtilsMessageSeverityFlagBitsEXTString(warning.severity), warning.id);
+            ImGui::TextUnformatted(warning.message.c_str());
+            ImGui::PopTextWrapPos();
+            ImGui::EndTooltip();
+        }
+        ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(warning.count));
+        ImGui::NextColumn();
+        ImGui::Text("%u", warning.frame_count);
+        ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(warning.last_frame));
+        ImGui::NextColumn();
+        for (auto&& object : warning.objects)
+            ImGui::TextUnformatted(object.c_str());
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+
+    ImGui::End();
+}
+
+void PassUIOverlay::render_memory_window()
+{
+    using blk::MemoryTracer;
+
+    constexpr const char* kLogFile = "vkplaygrounds-memory.csv";
+    constexpr float       kMiB     = 1.0f / (1024.0f * 1024.0f);
+
+    ImGui::SetNextWindowSize(ImVec2(600, 300), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Device Memory", &mUI.show_memory);
+
+    MemoryTracer& tracer = MemoryTracer::instance();
+    const MemoryTracer::Snapshot snapshot = tracer.snapshot();
+
+    {// Summary
+        VkDeviceSize allocated = 0, used = 0;
+        for (auto&& block : snapshot.blocks)
+        {
+            allocated += block.size;
+            used      += block.used();
+        }
+        ImGui::Text("%zu blocks, %.2f MiB allocated, %.2f MiB bound", snapshot.blocks.size(), allocated * kMiB, used * kMiB);
+        if (ImGui::Button("Snapshot"))
+            mMemorySnapshot = std::make_unique<MemoryTracer::Snapshot>(snapshot);
+        ImGui::SameLine();
+        if (ImGui::Button("Export Log"))
+        {
+            std::ofstream stream(kLogFile);
+            tracer.export_log(stream);
+        }
+    }
+
+    if (mMemorySnapshot && ImGui::CollapsingHeader("Difference", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        const MemoryTracer::Difference difference = MemoryTracer::difference(*mMemorySnapshot, snapshot);
+        ImGui::Text(
+            "Since frame %llu: %zu allocated, %zu freed, %zu changed, %+.2f MiB",
+            static_cast<unsigned long long>(mMemorySnapshot->frame),
+            difference.allocated.size(),
+            difference.freed.size(),
+            difference.changed.size(),
+            difference.bytes * kMiB
+        );
+        for (auto&& [prefix, blocks] : { std::pair{ "+", &difference.allocated }, std::pair{ "-", &difference.freed }, std::pair{ "~", &difference.changed } })
+        {
+            for (auto&& block : *blocks)
+                ImGui::BulletText("%s %s #%llu: %.2f MiB, %zu resources", prefix, block.name ? block.name : "(unnamed)", static_cast<unsigned long long>(block.id), block.size * kMiB, block.suballocations.size());
+        }
+    }
+
+    {// Occupancy, one bar per block : bound resources, holes below the cursor, then free space
+        constexpr ImU32 kHoleColor = IM_COL32(160,  48,  48, 255);
+        constexpr ImU32 kFreeColor = IM_COL32( 48,  48,  48, 255);
+
+        ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        const float width  = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+        const float height = ImGui::GetTextLineHeight();
+        for (auto&& block : snapshot.blocks)
+        {
+            ImGui::Text(
+                "%s #%llu - type %u, heap %u, %.2f / %.2f MiB, fragmentation %.0f%%",
+                block.name ? block.name : "(unnamed)",
+                static_cast<unsigned long long>(block.id),
+                block.type,
+                block.heap,
+                block.used() * kMiB,
+                block.size * kMiB,
+                100.0f * block.fragmentation()
+            );
+
+            const ImVec2 origin = ImGui::GetCursorScreenPos();
+            const float  scale  = width / static_cast<float>(std::max<VkDeviceSize>(block.size, 1));
+            draw_list->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), kFreeColor);
+            draw_list->AddRectFilled(origin, ImVec2(origin.x + std::min<VkDeviceSize>(block.next_offset, block.size) * scale, origin.y + height), kHoleColor);
+            for (auto&& suballocation : block.suballocations)
+            {
+                const float x0 = origin.x + suballocation.offset * scale;
+                const float x1 = std::max(x0 + 1.0f, origin.x + (suballocation.offset + suballocation.size) * scale);
+
+                // NOTE Names are string literals, their address is a stable color key
+                const std::size_t key = std::hash<const char*>{}(suballocation.owner);
+                const ImU32 color = IM_COL32(64 + (key & 0x7F), 96 + ((key >> 7) & 0x7F), 64 + ((key >> 14) & 0x7F), 255);
+                draw_list->AddRectFilled(ImVec2(x0, origin.y), ImVec2(x1, origin.y + height), color);
+
+                if (ImGui::IsMouseHoveringRect(ImVec2(x0, origin.y), ImVec2(x1, origin.y + height)))
+                    ImGui::SetTooltip(
+                        "%s (%s): offset %llu, %llu bytes",
+                        suballocation.owner ? suballocation.owner : "(unnamed)",
+                        suballocation.image ? "image" : "buffer",
+                        static_cast<unsigned long long>(suballocation.offset),
+                        static_cast<unsigned long long>(suballocation.size)
+                    );
             }
-            {// Index
-                CHECK(vkMapMemory(
-                    mDevice,
-                    *mIndexBuffer.mMemory,
-                    mIndexBuffer.mOffset,
-                    indexsize,
-                    0,
-                    reinterpret_cast<void**>(&address_index)
-                ));
-                for(auto idx = 0, count = data->CmdListsCount; idx < count; ++idx)
+            ImGui::Dummy(ImVec2(width, height));
+        }
+    }
+
+    ImGui::End();
+}
+
+void PassUIOverlay::optimize_imgui_draw_data()
+{
+    BLK_PROFILE_ZONE("PassUIOverlay::optimize_imgui_draw_data");
+    const ImDrawData* data = draw_data();
+    assert(data);
+    assert(data->Valid);
+
+    // Utilities to project scissor/clipping rectangles into framebuffer space
+    const ImVec2 clip_offset = data->DisplayPos;        // (0,0) unless using multi-viewports
+    const ImVec2 clip_scale  = data->FramebufferScale;  // (1,1) unless using retina display which are often (2,2)
+
+    const float framebuffer_width  = data->DisplaySize.x * data->FramebufferScale.x;
+    const float framebuffer_height = data->DisplaySize.y * data->FramebufferScale.y;
+
+    mDrawBatches.clear();
+    mDrawStatistics = DrawStatistics{};
+    for (auto idx_list = 0, count_list = data->CmdListsCount; idx_list < count_list; ++idx_list)
+    {
+        const ImDrawList* list = data->CmdLists[idx_list];
+        for (auto idx_buffer = 0, count_buffer = list->CmdBuffer.Size; idx_buffer < count_buffer; ++idx_buffer)
+        {
+            const ImDrawCmd& command = list->CmdBuffer[idx_buffer];
+            assert(command.UserCallback == nullptr);
+
+            ++mDrawStatistics.commands;
+
+            if (command.ElemCount == 0)
+                continue;
+
+            // Clip Rect in framebuffer space, clamped to the framebuffer
+            const float x0 = std::max((command.ClipRect.x - clip_offset.x) * clip_scale.x, 0.0f);
+            const float y0 = std::max((command.ClipRect.y - clip_offset.y) * clip_scale.y, 0.0f);
+            const float x1 = std::min((command.ClipRect.z - clip_offset.x) * clip_scale.x, framebuffer_width);
+            const float y1 = std::min((command.ClipRect.w - clip_offset.y) * clip_scale.y, framebuffer_height);
+
+            // Fully clipped
+            if ((x1 <= x0) || (y1 <= y0))
+                continue;
+
+            const VkRect2D scissor{
+                .offset = VkOffset2D{
+                    .x = static_cast<std::int32_t>(x0),
+                    .y = static_cast<std::int32_t>(y0),
+                },
+                .extent = VkExtent2D{
+                    .width  = static_cast<std::uint32_t>(x1 - x0),
+                    .height = static_cast<std::uint32_t>(y1 - y0),
+                }
+            };
+
+            // Coalesce with previous command when state is identical and indices are contiguous
+            if (!mDrawBatches.empty())
+            {
+                DrawBatch& previous = mDrawBatches.back();
+                const bool mergeable = (previous.list == static_cast<std::uint32_t>(idx_list))
+                    && (previous.texture == command.TextureId)
+                    && (previous.vertex_offset == command.VtxOffset)
+                    && (previous.first_index + previous.index_count == command.IdxOffset)
+                    && same_rectangle(previous.scissor, scissor);
+                if (mergeable)
                 {
-                    const ImDrawList* list = data->CmdLists[idx];
-                    std::copy(list->IdxBuffer.Data, std::next(list->IdxBuffer.Data, list->IdxBuffer.Size), address_index);
-                    address_index  += list->IdxBuffer.Size;
+                    previous.index_count += command.ElemCount;
+                    continue;
                 }
-                vkUnmapMemory(mDevice, *mIndexBuffer.mMemory);
             }
+
+            mDrawBatches.push_back(DrawBatch{
+                .texture       = command.TextureId,
+                .scissor       = scissor,
+                .list          = static_cast<std::uint32_t>(idx_list),
+                .first_index   = command.IdxOffset,
+                .index_count   = command.ElemCount,
+                .vertex_offset = command.VtxOffset,
+            });
         }
     }
-    else
+    mDrawStatistics.draws = static_cast<std::uint32_t>(mDrawBatches.size());
+}
+
+void PassUIOverlay::upload_imgui_draw_data()
+{
+    BLK_PROFILE_ZONE("PassUIOverlay::upload_imgui_draw_data");
+    const ImDrawData* data = draw_data();
+    assert(data);
+    assert(data->Valid);
+
+    if (mPackedVertices != mUI.packed_vertices)
+    {// Vertex format changed, every region is re-allocated and re-uploaded
+        mPackedVertices = mUI.packed_vertices;
+        mDrawListSlots.clear();
+        mVertexCursor = 0;
+        mIndexCursor  = 0;
+    }
+
+    const std::size_t vertex_stride = mPackedVertices ? sizeof(PackedVertex) : sizeof(ImDrawVert);
+
+    const std::uint32_t vertex_capacity = static_cast<std::uint32_t>(mVertexBuffer.mInfo.size / vertex_stride);
+    const std::uint32_t index_capacity  = static_cast<std::uint32_t>(mIndexBuffer .mInfo.size / sizeof(ImDrawIdx));
+
+    assert(static_cast<std::uint32_t>(data->TotalVtxCount) <= vertex_capacity);
+    assert(static_cast<std::uint32_t>(data->TotalIdxCount) <= index_capacity);
+
+    struct Entry
+    {
+        const ImDrawList* list;
+        DrawListSlot*     slot;
+        std::uint32_t     vertex_count;
+        std::uint32_t     index_count;
+        bool              upload_vertices;
+        bool              upload_indices;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(data->CmdListsCount);
+
+    {// Content Hashes
+        for (auto&& [list, slot] : mDrawListSlots)
+            slot.used = false;
+
+        for (auto idx = 0, count = data->CmdListsCount; idx < count; ++idx)
+        {
+            const ImDrawList* list = data->CmdLists[idx];
+            const auto vertex_count = static_cast<std::uint32_t>(list->VtxBuffer.Size);
+            const auto index_count  = static_cast<std::uint32_t>(list->IdxBuffer.Size);
+            const std::uint64_t vertex_hash = content_hash(list->VtxBuffer.Data, vertex_count * sizeof(ImDrawVert));
+            const std::uint64_t index_hash  = content_hash(list->IdxBuffer.Data, index_count  * sizeof(ImDrawIdx));
+
+            auto [finder, inserted] = mDrawListSlots.try_emplace(list);
+            DrawListSlot& slot = finder->second;
+            slot.used = true;
+
+            entries.push_back(Entry{
+                .list            = list,
+                .slot            = &slot,
+                .vertex_count    = vertex_count,
+                .index_count     = index_count,
+                .upload_vertices = inserted || (slot.vertex_hash != vertex_hash),
+                .upload_indices  = inserted || (slot.index_hash  != index_hash),
+            });
+            slot.vertex_hash = vertex_hash;
+            slot.index_hash  = index_hash;
+        }
+
+        // NOTE Regions of dropped draw lists are only reclaimed on compaction
+        std::erase_if(mDrawListSlots, [](const auto& element) { return !element.second.used; });
+    }
+
+    {// Regions Allocation
+        auto required = [&entries](bool headroom) {
+            std::uint32_t vertices = 0, indices = 0;
+            for (auto&& entry : entries)
+            {
+                if (entry.vertex_count > entry.slot->vertex_capacity)
+                    vertices += slot_capacity(entry.vertex_count, headroom);
+                if (entry.index_count > entry.slot->index_capacity)
+                    indices += slot_capacity(entry.index_count, headroom);
+            }
+            return std::make_pair(vertices, indices);
+        };
+
+        bool headroom = true;
+        auto [vertices, indices] = required(headroom);
+        if ((mVertexCursor + vertices > vertex_capacity) || (mIndexCursor + indices > index_capacity))
+        {// Compaction, every region is allocated from scratch
+            mVertexCursor = 0;
+            mIndexCursor  = 0;
+            for (auto&& entry : entries)
+            {
+                entry.slot->vertex_capacity = 0;
+                entry.slot->index_capacity  = 0;
+            }
+            std::tie(vertices, indices) = required(headroom);
+            headroom = (vertices <= vertex_capacity) && (indices <= index_capacity);
+        }
+
+        for (auto&& entry : entries)
+        {
+            DrawListSlot& slot = *entry.slot;
+            if (entry.vertex_count > slot.vertex_capacity)
+            {
+                slot.vertex_capacity = slot_capacity(entry.vertex_count, headroom);
+                slot.vertex_offset   = mVertexCursor;
+                mVertexCursor       += slot.vertex_capacity;
+                entry.upload_vertices = true;
+            }
+            if (entry.index_count > slot.index_capacity)
+            {
+                slot.index_capacity = slot_capacity(entry.index_count, headroom);
+                slot.index_offset   = mIndexCursor;
+                mIndexCursor       += slot.index_capacity;
+                entry.upload_indices = true;
+            }
+        }
+        assert(mVertexCursor <= vertex_capacity);
+        assert(mIndexCursor  <= index_capacity);
+
+        mVertexBuffer.mOccupied = mVertexCursor * vertex_stride;
+        mIndexBuffer .mOccupied = mIndexCursor  * sizeof(ImDrawIdx);
+    }
+
+    mUploadStatistics = UploadStatistics{
+        .uploaded = 0,
+        .total    = data->TotalVtxCount * vertex_stride + data->TotalIdxCount * sizeof(ImDrawIdx),
+    };
+
+    // NOTE Vertex and index buffers may share the same memory, which can only be mapped once at a time
+    // NOTE(andrea.machizaud) Coherent memory no invalidate/flush
+    if (std::ranges::any_of(entries, &Entry::upload_vertices))
+    {// Vertex
+        std::byte* address_vertex = nullptr;
+        CHECK(vkMapMemory(
+            mDevice,
+            *mVertexBuffer.mMemory,
+            mVertexBuffer.mOffset,
+            mVertexBuffer.mInfo.size,
+            0,
+            reinterpret_cast<void**>(&address_vertex)
+        ));
+        for (auto&& entry : entries | std::views::filter(&Entry::upload_vertices))
+        {
+            std::byte* destination = address_vertex + entry.slot->vertex_offset * vertex_stride;
+            if (mPackedVertices)
+                pack_vertices(entry.list->VtxBuffer.Data, entry.vertex_count, reinterpret_cast<PackedVertex*>(destination));
+            else
+                std::copy_n(entry.list->VtxBuffer.Data, entry.vertex_count, reinterpret_cast<ImDrawVert*>(destination));
+            mUploadStatistics.uploaded += entry.vertex_count * vertex_stride;
+        }
+        vkUnmapMemory(mDevice, *mVertexBuffer.mMemory);
+    }
+    if (std::ranges::any_of(entries, &Entry::upload_indices))
+    {// Index
+        ImDrawIdx* address_index = nullptr;
+        CHECK(vkMapMemory(
+            mDevice,
+            *mIndexBuffer.mMemory,
+            mIndexBuffer.mOffset,
+            mIndexBuffer.mInfo.size,
+            0,
+            reinterpret_cast<void**>(&address_index)
+        ));
+        for (auto&& entry : entries | std::views::filter(&Entry::upload_indices))
+        {
+            std::copy_n(entry.list->IdxBuffer.Data, entry.index_count, address_index + entry.slot->index_offset);
+            mUploadStatistics.uploaded += entry.index_count * sizeof(ImDrawIdx);
+        }
+        vkUnmapMemory(mDevice, *mIndexBuffer.mMemory);
+    }
+
+    mDrawListRegions.clear();
+    for (auto&& entry : entries)
     {
-        mVertexBuffer.mOccupied = 0;
-        mIndexBuffer .mOccupied = 0;
+        mDrawListRegions.push_back(DrawListRegion{
+            .vertex_offset = entry.slot->vertex_offset,
+            .index_offset  = entry.slot->index_offset,
+        });
+    }
+
+    {// Cache Invalidation
+        const std::uint64_t batches_hash = content_hash(mDrawBatches.data(), mDrawBatches.size() * sizeof(DrawBatch));
+        if ((mUploadStatistics.uploaded > 0) || (std::exchange(mDrawBatchesHash, batches_hash) != batches_hash))
+            mCacheDirty = true;
     }
 }
 
+const ImDrawData* PassUIOverlay::draw_data() const
+{
+    return (mReplayDrawData != nullptr) ? mReplayDrawData : ImGui::GetDrawData();
+}
+
 void PassUIOverlay::upload_font_image(blk::Buffer& staging_buffer)
 {
     ImGuiIO& io = ImGui::GetIO();
@@ -855,7 +1919,24 @@ void PassUIOverlay::upload_font_image(blk::Buffer& staging_buffer)
 
 void PassUIOverlay::record_pass(VkCommandBuffer commandbuffer)
 {
-    const ImDrawData* data = ImGui::GetDrawData();
+    BLK_PROFILE_ZONE("PassUIOverlay::record_pass");
+    if (mCacheActive)
+    {
+        record_composite(commandbuffer);
+        return;
+    }
+
+    // NOTE Skip drawing until the pipeline, matching uploaded vertex format, compilation completes
+    VkPipeline pipeline = (mPackedVertices ? mPackedPipeline : mPipeline).acquire();
+    if (pipeline == VK_NULL_HANDLE)
+        return;
+
+    record_draws(commandbuffer, pipeline);
+}
+
+void PassUIOverlay::record_draws(VkCommandBuffer commandbuffer, VkPipeline pipeline)
+{
+    const ImDrawData* data = draw_data();
     assert(data);
     assert(data->Valid);
 
@@ -873,7 +1954,7 @@ void PassUIOverlay::record_pass(VkCommandBuffer commandbuffer)
         .maxDepth = 1.0f,
     };
 
-    vkCmdBindPipeline(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+    vkCmdBindPipeline(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
     vkCmdBindDescriptorSets(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout,
         0,
         1, &mDescriptorSet,
@@ -901,59 +1982,210 @@ void PassUIOverlay::record_pass(VkCommandBuffer commandbuffer)
         vkCmdBindIndexBuffer(commandbuffer, mIndexBuffer, offset, sizeof(ImDrawIdx) == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
     }
     {// Draws
-        // Utilities to project scissor/clipping rectangles into framebuffer space
-        const ImVec2 clip_offset = data->DisplayPos;        // (0,0) unless using multi-viewports
-        const ImVec2 clip_scale  = data->FramebufferScale;  // (1,1) unless using retina display which are often (2,2)
+        assert(mDrawListRegions.size() == static_cast<std::size_t>(data->CmdListsCount));
 
-        std::uint32_t offset_index = 0;
-        std::int32_t  offset_vertex = 0;
-        for (auto idx_list = 0, count_list = data->CmdListsCount; idx_list < count_list; ++idx_list)
+        mDrawStatistics.scissors = 0;
+        const VkRect2D* current_scissor = nullptr;
+        for (auto&& batch : mDrawBatches)
         {
-            const ImDrawList* list = data->CmdLists[idx_list];
-            for (auto idx_buffer = 0, count_buffer = list->CmdBuffer.Size; idx_buffer < count_buffer; ++idx_buffer)
+            const DrawListRegion& region = mDrawListRegions[batch.list];
+            if (!current_scissor || !same_rectangle(*current_scissor, batch.scissor))
             {
-                const ImDrawCmd& command = list->CmdBuffer[idx_buffer];
-                assert(command.UserCallback == nullptr);
-
-                // Clip Rect in framebuffer space
-                const ImVec4 framebuffer_clip_rectangle(
-                    (command.ClipRect.x - clip_offset.x) * clip_scale.x,
-                    (command.ClipRect.y - clip_offset.y) * clip_scale.y,
-                    (command.ClipRect.z - clip_offset.x) * clip_scale.x,
-                    (command.ClipRect.w - clip_offset.y) * clip_scale.y
-                );
+                vkCmdSetScissor(commandbuffer, 0, 1, &batch.scissor);
+                current_scissor = &batch.scissor;
+                ++mDrawStatistics.scissors;
+            }
+            vkCmdDrawIndexed(
+                commandbuffer,
+                batch.index_count,
+                1,
+                region.index_offset + batch.first_index,
+                static_cast<std::int32_t>(region.vertex_offset + batch.vertex_offset),
+                0
+            );
+        }
+    }
+}
 
-                const bool valid_clip(
-                    (framebuffer_clip_rectangle.x < viewport.width ) &&
-                    (framebuffer_clip_rectangle.y < viewport.height) &&
-                    (framebuffer_clip_rectangle.w >= 0.0           ) &&
-                    (framebuffer_clip_rectangle.w >= 0.0           )
-                );
-                if (valid_clip)
-                {
-                    const VkRect2D scissors{
-                        .offset = VkOffset2D{
-                            .x = std::max(static_cast<std::int32_t>(framebuffer_clip_rectangle.x), 0),
-                            .y = std::max(static_cast<std::int32_t>(framebuffer_clip_rectangle.y), 0),
-                        },
-                        .extent = VkExtent2D{
-                            .width  = static_cast<std::uint32_t>(framebuffer_clip_rectangle.z - framebuffer_clip_rectangle.x),
-                            .height = static_cast<std::uint32_t>(framebuffer_clip_rectangle.w - framebuffer_clip_rectangle.y),
-                        }
-                    };
+void PassUIOverlay::record_composite(VkCommandBuffer commandbuffer)
+{
+    const VkViewport viewport{
+        .x        = 0.0f,
+        .y        = 0.0f,
+        .width    = static_cast<float>(mResolution.width),
+        .height   = static_cast<float>(mResolution.height),
+        .minDepth = 0.0f,
+        .maxDepth = 1.0f,
+    };
+    const VkRect2D scissor{
+        .offset = VkOffset2D{
+            .x = 0,
+            .y = 0,
+        },
+        .extent = mResolution,
+    };
+
+    vkCmdBindPipeline(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mCompositePipeline.acquire());
+    vkCmdBindDescriptorSets(commandbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout,
+        0,
+        1, &mCacheDescriptorSet,
+        0, nullptr
+    );
+    vkCmdSetViewport(commandbuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandbuffer, 0, 1, &scissor);
+    // Fullscreen triangle
+    vkCmdDraw(commandbuffer, 3, 1, 0, 0);
+}
+
+void PassUIOverlay::recreate_cache(VkImageView stencilview)
+{
+    // NOTE Latest frame may still use them
+    mEngine.mRetireQueue.retire(
+        [device = static_cast<VkDevice>(mDevice), framebuffer = std::exchange(mCacheFramebuffer, VkFramebuffer{VK_NULL_HANDLE})]{
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
+    );
+
+    // NOTE Cache image is composited with texelFetch, it may be larger than the resolution
+    if (const VkExtent2D extent = bucket_extent(mResolution); !same_extent(extent, mCacheExtent) || !mCacheImage.created())
+    {
+        mCacheExtent = extent;
+        mEngine.mRetireQueue.retire_objects(std::move(mCacheImageView), std::move(mCacheImage), std::move(mCacheMemory));
+
+        mCacheImage = blk::Image(
+            VkExtent3D{ .width = mCacheExtent.width, .height = mCacheExtent.height, .depth = 1 },
+            VK_IMAGE_TYPE_2D,
+            mCacheFormat,
+            VK_SAMPLE_COUNT_1_BIT,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED
+        );
+        mCacheImage.create(mDevice, "UI Cache");
+        {// Memory
+            const auto& vkphysicaldevice = *(mDevice.mPhysicalDevice);
+            auto memory_type = vkphysicaldevice.mMemories.find_compatible(mCacheImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            assert(memory_type);
+            mCacheMemory = std::make_unique<blk::Memory>(*memory_type, mCacheImage.mRequirements.size);
+            mCacheMemory->allocate(mDevice, "UI Cache");
+            mCacheMemory->bind(mCacheImage);
+        }
+        mCacheImageView = blk::ImageView(
+            mCacheImage,
+            VK_IMAGE_VIEW_TYPE_2D,
+            mCacheFormat,
+            VK_IMAGE_ASPECT_COLOR_BIT
+        );
+        mCacheImageView.create(mDevice, "UI Cache");
 
-                    vkCmdSetScissor(commandbuffer, 0, 1, &scissors);
-                    vkCmdDrawIndexed(commandbuffer, command.ElemCount, 1, command.IdxOffset + offset_index, command.VtxOffset + offset_vertex, 0);
+        // NOTE Descriptor set cannot be updated while in use, alternate once per frame
+        if (mCacheDescriptorSerial != mEngine.mRetireQueue.mSerial)
+        {
+            mCacheDescriptorSet    = (mCacheDescriptorSet == mCacheDescriptorSets[0]) ? mCacheDescriptorSets[1] : mCacheDescriptorSets[0];
+            mCacheDescriptorSerial = mEngine.mRetireQueue.mSerial;
+        }
+        {// Update DescriptorSet
+            const VkDescriptorImageInfo info{
+                .sampler     = VK_NULL_HANDLE,
+                .imageView   = mCacheImageView,
+                .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            };
+            const VkWriteDescriptorSet write{
+                .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .pNext            = nullptr,
+                .dstSet           = mCacheDescriptorSet,
+                .dstBinding       = kShaderBindingCacheTexture,
+                .dstArrayElement  = 0,
+                .descriptorCount  = 1,
+                .descriptorType   = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .pImageInfo       = &info,
+                .pBufferInfo      = nullptr,
+                .pTexelBufferView = nullptr,
+            };
+            vkUpdateDescriptorSets(mDevice, 1, &write, 0, nullptr);
+        }
+    }
+    {// Framebuffer
+        const std::array attachments{
+            (VkImageView)mCacheImageView,
+            stencilview
+        };
+        const VkFramebufferCreateInfo info{
+            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .pNext           = nullptr,
+            .flags           = 0u,
+            .renderPass      = mCacheRenderPass,
+            .attachmentCount = attachments.size(),
+            .pAttachments    = attachments.data(),
+            .width           = mResolution.width,
+            .height          = mResolution.height,
+            .layers          = 1,
+        };
+        CHECK(vkCreateFramebuffer(mDevice, &info, nullptr, &mCacheFramebuffer));
+    }
+    mCacheDirty = true;
+}
+
+bool PassUIOverlay::update_cache(VkCommandBuffer commandbuffer)
+{
+    BLK_PROFILE_ZONE("PassUIOverlay::update_cache");
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (mUI.cache_ui && (mCacheFramebuffer != VK_NULL_HANDLE) && (mCompositePipeline.acquire() != VK_NULL_HANDLE))
+        pipeline = (mPackedVertices ? mPackedCachePipeline : mCachePipeline).acquire();
+
+    if (pipeline == VK_NULL_HANDLE)
+    {// NOTE Stencil is not preserved while the cache is unused, render it again once enabled
+        mCacheDirty  = true;
+        mCacheActive = false;
+        return false;
+    }
+
+    if (mCacheDirty)
+    {
+        constexpr std::array kClearValues {
+            VkClearValue {
+                .color = VkClearColorValue{
+                    .float32 = { 0.0f, 0.0f, 0.0f, 0.0f }
+                },
+            },
+            VkClearValue {
+                .depthStencil = VkClearDepthStencilValue{
+                    .depth   = 0.0f,
+                    .stencil = 0,
                 }
             }
-            offset_index  += list->IdxBuffer.Size;
-            offset_vertex += list->VtxBuffer.Size;
-        }
+        };
+        const VkRenderPassBeginInfo info{
+            .sType            = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .pNext            = nullptr,
+            .renderPass       = mCacheRenderPass,
+            .framebuffer      = mCacheFramebuffer,
+            .renderArea       = VkRect2D{
+                .offset = VkOffset2D{
+                    .x = 0,
+                    .y = 0,
+                },
+                .extent = mResolution,
+            },
+            .clearValueCount  = kClearValues.size(),
+            .pClearValues     = kClearValues.data(),
+        };
+        vkCmdBeginRenderPass(commandbuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+        record_draws(commandbuffer, pipeline);
+        vkCmdEndRenderPass(commandbuffer);
+
+        mCacheDirty = false;
+        ++mCacheUpdates;
     }
+
+    mCacheActive = true;
+    return true;
 }
 
 void PassUIOverlay::record_font_image_upload(VkCommandBuffer commandbuffer, const blk::Buffer& staging_buffer)
 {
+    const blk::debug::ScopedLabel label(commandbuffer, "UI Font Upload");
+
     {// Image Barrier VK_IMAGE_LAYOUT_UNDEFINED -> VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
         const VkImageMemoryBarrier imagebarrier{
             .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
@@ -1040,6 +2272,49 @@ void PassUIOverlay::record_font_image_upload(VkCommandBuffer commandbuffer, cons
     }
 }
 
+void PassUIOverlay::submit_font_image_upload()
+{
+    assert(!mFontImageSemaphorePending);
+
+    // Uploaded from host
+    if (mFontHostUpload)
+        return;
+
+    mEngine.submit(
+        *mGraphicsQueue,
+        { mFontImageStagingCommandBuffer },
+        { },
+        { },
+        { mFontImageStagingSemaphore },
+        mFontImageStagingFence
+    );
+    mFontImageSemaphorePending = true;
+}
+
+VkSemaphore PassUIOverlay::consume_font_image_semaphore()
+{
+    return std::exchange(mFontImageSemaphorePending, false) ? mFontImageStagingSemaphore : VK_NULL_HANDLE;
+}
+
+bool PassUIOverlay::poll_font_image_upload()
+{
+    // Already released
+    if (mFontImageStagingFence == VK_NULL_HANDLE)
+        return true;
+
+    // NOTE A signaled semaphore can be destroyed, but it would leave the first frame without font synchronization
+    if (mFontImageSemaphorePending)
+        return false;
+
+    const VkResult status = vkGetFenceStatus(mDevice, mFontImageStagingFence);
+    if (status == VK_NOT_READY)
+        return false;
+    CHECK(status);
+
+    clear_font_image_transient_data();
+    return true;
+}
+
 void PassUIOverlay::clear_font_image_transient_data()
 {
     mFontImageStagingBuffer.destroy();
@@ -1060,6 +2335,8 @@ void PassUIOverlay::onResize(const VkExtent2D& resolution)
     
     ImGuiIO& io = ImGui::GetIO();
     io.DisplaySize = ImVec2(mResolution.width, mResolution.height);
+
+    invalidate();
 }
 
 }
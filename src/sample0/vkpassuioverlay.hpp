@@ -8,15 +8,21 @@
 #include <chrono>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 #include "./vkdevice.hpp"
 #include "./vkrenderpass.hpp"
 #include "./vkbuffer.hpp"
 #include "./vkimage.hpp"
+#include "./vkmemorytracer.hpp"
 
 #include "./vkpass.hpp"
+#include "./vkpresentation.hpp"
+#include "./vkpipelinecompiler.hpp"
 
 struct ImGuiContext;
+struct ImDrawList;
+struct ImDrawData;
 
 namespace blk
 {
@@ -27,6 +33,10 @@ namespace blk
 
 namespace blk::sample0
 {
+    struct DrawDataRecorder;
+    struct InputRecorder;
+    struct InputReplay;
+
     struct PassUIOverlay : Pass
     {
         using frame_clock_t         = std::chrono::high_resolution_clock;
@@ -34,10 +44,22 @@ namespace blk::sample0
         using frame_time_delta_s_t  = std::chrono::duration<float/*, std::seconds*/>;
         using frame_time_delta_ms_t = std::chrono::duration<float, std::milli>;
 
+        // Label of the subpass, see blk::record_subpass
+        static constexpr const char* kName = "UI Overlay";
+
         struct Arguments
         {
             blk::Engine& engine;
             VkExtent2D   resolution;
+            VkFormat     color_format;
+            VkFormat     depth_format;
+        };
+
+        // Offscreen UI rendering : color is composited in the main pass, stencil is re-used as is by the main pass
+        //  Color & stencil end up in read-only layouts
+        struct CacheRenderPass : blk::RenderPass
+        {
+            CacheRenderPass(const blk::Device& vkdevice, VkFormat formatColor, VkFormat formatDepth);
         };
 
         // TODO Re-use pipeline cache object, instead of one per pass
@@ -46,14 +68,51 @@ namespace blk::sample0
 
         void initialize_graphic_pipelines();
 
+        // NOTE Called from pipeline compiler worker threads
+        VkPipeline create_graphic_pipeline(bool packed, VkRenderPass renderpass, std::uint32_t subpass) const;
+        VkPipeline create_composite_pipeline() const;
+
+        // Whether input, resize or an animated widget requires a new ImGui frame
+        bool need_imgui_frame() const;
+        // Force new ImGui frames for a short while (e.g. keyboard input, resize)
+        void invalidate();
+
         void render_imgui_frame();
+        // Flame view of the CPU zones of the latest complete frame, see blk::profiler::Profiler
+        void render_profiler_window();
+        // Performance messages sorted by the selected column, see blk::PerformanceWarnings
+        void render_performance_warnings_window();
+        // Occupancy map per device memory block, and difference to a snapshot, see blk::MemoryTracer
+        void render_memory_window();
+        // Coalesce ImGui draw commands into draw batches, dropping empty and fully clipped ones
+        void optimize_imgui_draw_data();
         void upload_imgui_draw_data();
+        // Draw data optimized, uploaded and drawn : mReplayDrawData when set, the latest ImGui one otherwise
+        const ImDrawData* draw_data() const;
 
         void upload_font_image(blk::Buffer& staging_buffer);
         void record_font_image_upload(VkCommandBuffer commandbuffer, const blk::Buffer& staging_buffer);
+        // Submit the recorded font upload without waiting for it, see consume_font_image_semaphore
+        void submit_font_image_upload();
+        // Semaphore signaled by the font upload, returned once to be waited by the first frame submission
+        VkSemaphore consume_font_image_semaphore();
+        // Release font upload transient data once its fence is signaled
+        //  NOTE The submission that consumed the semaphore must have completed
+        //  Returns whether transient data are released
+        bool poll_font_image_upload();
         void clear_font_image_transient_data();
 
         void record_pass(VkCommandBuffer commandbuffer) override;
+        void record_draws(VkCommandBuffer commandbuffer, VkPipeline pipeline);
+        void record_composite(VkCommandBuffer commandbuffer);
+
+        // (Re-)create the cache framebuffer, stencil view is shared with the main framebuffers
+        //  The cache image is only re-created when the resolution leaves its extent bucket
+        //  NOTE Previous cache objects are retired, see Engine::mRetireQueue
+        void recreate_cache(VkImageView stencilview);
+        // Render the UI into the cache if its content changed, outside of any render pass
+        //  Returns whether the cache is used this frame, i.e. the main pass must load the cached stencil and composite
+        bool update_cache(VkCommandBuffer commandbuffer);
 
         void onResize(const VkExtent2D& resolution);
 
@@ -73,11 +132,98 @@ namespace blk::sample0
 
         VkPipelineCache                      mPipelineCache                = VK_NULL_HANDLE;
 
-        VkPipeline                           mPipeline                     = VK_NULL_HANDLE;
+        // ImDrawVert and PackedVertex vertex formats
+        blk::AsyncPipeline                   mPipeline;
+        blk::AsyncPipeline                   mPackedPipeline;
+        // Same, against the cache render pass
+        blk::AsyncPipeline                   mCachePipeline;
+        blk::AsyncPipeline                   mPackedCachePipeline;
+        blk::AsyncPipeline                   mCompositePipeline;
 
         VkDescriptorPool                     mDescriptorPool               = VK_NULL_HANDLE;
         VkDescriptorSet                      mDescriptorSet                = VK_NULL_HANDLE;
 
+        // UI Cache
+        VkFormat                             mCacheFormat;
+        // Rounded-up extent the cache image is allocated with, see bucket_extent
+        VkExtent2D                           mCacheExtent                  = {};
+        CacheRenderPass                      mCacheRenderPass;
+        blk::Image                           mCacheImage;
+        blk::ImageView                       mCacheImageView;
+        std::unique_ptr<blk::Memory>         mCacheMemory;
+        VkFramebuffer                        mCacheFramebuffer             = VK_NULL_HANDLE;
+        VkDescriptorSet                      mCacheDescriptorSet           = VK_NULL_HANDLE;
+        // Cache descriptor set in use is swapped when recreated, the previous one may be in use by the latest frame
+        std::array<VkDescriptorSet, 2>       mCacheDescriptorSets          = {};
+        std::uint64_t                        mCacheDescriptorSerial        = ~0ull;
+        // Draw batches as last rendered into the cache
+        std::uint64_t                        mDrawBatchesHash              = 0;
+        bool                                 mCacheDirty                   = true;
+        bool                                 mCacheActive                  = false;
+        std::uint32_t                        mCacheUpdates                 = 0;
+
+        // Region of a draw list within vertex/index buffers, re-uploaded only when its content changes
+        struct DrawListSlot
+        {
+            std::uint64_t vertex_hash     = 0;
+            std::uint64_t index_hash      = 0;
+            // NOTE In vertices/indices, not bytes
+            std::uint32_t vertex_offset   = 0;
+            std::uint32_t vertex_capacity = 0;
+            std::uint32_t index_offset    = 0;
+            std::uint32_t index_capacity  = 0;
+            bool          used            = false;
+        };
+        struct DrawListRegion
+        {
+            std::uint32_t vertex_offset = 0;
+            std::uint32_t index_offset  = 0;
+        };
+        // Contiguous draw commands with identical state, offsets are relative to the draw list region
+        //  NOTE No padding, batches are hashed
+        struct DrawBatch
+        {
+            void*         texture;
+            VkRect2D      scissor;
+            std::uint32_t list;
+            std::uint32_t first_index;
+            std::uint32_t index_count;
+            std::uint32_t vertex_offset;
+        };
+        std::vector<DrawBatch>               mDrawBatches;
+        // Records every ImGui frame while mUI.record_draw_data is set
+        std::unique_ptr<DrawDataRecorder>    mDrawDataRecorder;
+        // Replayed instead of ImGui draw data, see DrawDataReplay
+        const ImDrawData*                    mReplayDrawData = nullptr;
+
+        // Records input and timing sampled by every ImGui frame
+        std::unique_ptr<InputRecorder>       mInputRecorder;
+        // Replaces input and timing of ImGui frames until finished, frame deltas are then mFixedTimestep
+        std::unique_ptr<InputReplay>         mInputReplay;
+        frame_time_delta_ms_t                mFixedTimestep = frame_time_delta_ms_t(1000.0f / 60.0f);
+
+        // Reference of the device memory difference, see render_memory_window
+        std::unique_ptr<blk::MemoryTracer::Snapshot> mMemorySnapshot;
+        struct DrawStatistics
+        {
+            std::uint32_t commands = 0;
+            std::uint32_t draws    = 0;
+            std::uint32_t scissors = 0;
+        }                                    mDrawStatistics;
+
+        std::unordered_map<const ImDrawList*, DrawListSlot> mDrawListSlots;
+        // Regions of ImDrawData::CmdLists, in order, as last uploaded
+        std::vector<DrawListRegion>          mDrawListRegions;
+        std::uint32_t                        mVertexCursor = 0;
+        std::uint32_t                        mIndexCursor  = 0;
+        // Vertex format currently uploaded
+        bool                                 mPackedVertices = false;
+        struct UploadStatistics
+        {
+            VkDeviceSize uploaded = 0;
+            VkDeviceSize total    = 0;
+        }                                    mUploadStatistics;
+
         std::unique_ptr<blk::Memory>         mGeometryMemory;
         std::unique_ptr<blk::Memory>         mIndexMemory;
         std::unique_ptr<blk::Memory>         mVertexMemory;
@@ -94,14 +240,20 @@ namespace blk::sample0
         VkCommandPool                        mGraphicsCommandPoolGeneral = VK_NULL_HANDLE;
         VkCommandPool                        mGraphicsCommandPoolTransient = VK_NULL_HANDLE;
 
+        // Font atlas written from host memory (VK_EXT_host_image_copy), without any transient data
+        bool                                 mFontHostUpload                = false;
+
         // Font Image Transient Data
         blk::Buffer                          mFontImageStagingBuffer;
         VkFence                              mFontImageStagingFence         = VK_NULL_HANDLE;
         VkSemaphore                          mFontImageStagingSemaphore     = VK_NULL_HANDLE;
         VkCommandBuffer                      mFontImageStagingCommandBuffer = VK_NULL_HANDLE;
+        // Submitted, but semaphore not waited yet
+        bool                                 mFontImageSemaphorePending     = false;
 
         std::chrono::time_point<std::chrono::high_resolution_clock> mStartTick;
         std::chrono::time_point<std::chrono::high_resolution_clock> mFrameTick;
+        std::chrono::time_point<std::chrono::high_resolution_clock> mInvalidationTick;
 
         struct UI {
             frame_time_delta_ms_t frame_delta = frame_time_delta_ms_t(0.f);
@@ -115,6 +267,56 @@ namespace blk::sample0
             bool                  show_gpu_information = false;
             bool                  show_fps = false;
             bool                  show_demo = false;
+            // Do not render frames when nothing changed
+            bool                  render_on_demand = false;
+            // Quantized vertices, see PackedVertex
+            bool                  packed_vertices = false;
+            // Render the UI offscreen, only when it changed, and composite it
+            bool                  cache_ui = false;
+            // Capture draw data into a file, see DrawDataRecorder
+            bool                  record_draw_data = false;
+            // Presentation, changes are applied by the application, which reports the resulting mode
+            blk::PresentPolicy    present_policy = blk::PresentPolicy::PowerSaving;
+            bool                  present_policy_changed = false;
+            VkPresentModeKHR      present_mode = VK_PRESENT_MODE_FIFO_KHR;
+            // Frame pacing, target is applied by the application, which reports interval statistics (in milliseconds)
+            float                 target_frame_interval = 0.0f;
+            bool                  pacing_present_wait = false;
+            float                 pacing_mean   = 0.0f;
+            float                 pacing_jitter = 0.0f;
+            float                 pacing_min    = 0.0f;
+            float                 pacing_max    = 0.0f;
+            // Latency, see blk::LatencyController (in milliseconds)
+            bool                  jit_frame_start = false;
+            bool                  latency_measured = false;
+            float                 latency       = 0.0f;
+            float                 latency_cpu   = 0.0f;
+            float                 latency_gpu   = 0.0f;
+            float                 latency_sleep = 0.0f;
+            // Dynamic resolution, see blk::ResolutionScaler, applied by the sample which reports the scene extent
+            bool                  dynamic_resolution = false;
+            float                 target_gpu_time    = 8.0f; // ms
+            float                 upscale_sharpness  = 0.0f;
+            bool                  gpu_timestamps     = false;
+            float                 gpu_time           = 0.0f; // ms
+            VkExtent2D            scene_extent       = {};
+            // Pipeline statistics per pass of the latest completed frame, see blk::PipelineStatisticsQueries
+            struct PassStatistics
+            {
+                const char*             name;
+                blk::PipelineStatistics statistics;
+            };
+            bool                        pipeline_statistics = false;
+            std::vector<PassStatistics> pass_statistics;
+            // CPU zones, see BLK_PROFILE_ZONE
+            bool                  show_profiler      = false;
+            // Validation layer performance messages, see blk::PerformanceWarnings
+            bool                  show_performance_warnings      = false;
+            // Column index, see PassUIOverlay::render_performance_warnings_window
+            int                   performance_warnings_sort      = 1;
+            bool                  performance_warnings_ascending = false;
+            // Device memory blocks, see blk::MemoryTracer
+            bool                  show_memory        = false;
         } mUI;
 
         struct Mouse
@@ -124,19 +326,28 @@ namespace blk::sample0
                 bool left   = false;
                 bool middle = false;
                 bool right  = false;
+
+                bool operator==(const Buttons&) const = default;
             } buttons;
             struct Positions
             {
                 float x = 0.0f;
                 float y = 0.0f;
+
+                bool operator==(const Positions&) const = default;
             } offset;
             struct Wheel
             {
                 float vdelta = 0.0f;
                 float hdelta = 0.0f;
+
+                bool operator==(const Wheel&) const = default;
             } wheel;
-        } mMouse;
 
+            bool operator==(const Mouse&) const = default;
+        } mMouse;
+        // Mouse state as last fed to ImGui
+        Mouse                                mFedMouse;
 
         static_assert(std::chrono::treat_as_floating_point_v<frame_time_delta_s_t::rep>, "required to be floating point");
         static_assert(std::chrono::treat_as_floating_point_v<frame_time_delta_ms_t::rep>, "required to be floating point");
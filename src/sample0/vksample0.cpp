@@ -4,7 +4,11 @@
 #include "../vkdevice.hpp"
 #include "../vkphysicaldevice.hpp"
 
+#include "../vkqueue.hpp"
 #include "../vkmemory.hpp"
+#include "../vkutilities.hpp"
+#include "../vkdebugutils.hpp"
+#include "../vkprofiler.hpp"
 
 #include <vulkan/vulkan_core.h>
 
@@ -26,16 +30,26 @@ namespace
         VK_FORMAT_D16_UNORM,
         VK_FORMAT_D32_SFLOAT,
     };
+
+    constexpr std::uint32_t kTimestampFrameBegin     = 0;
+    constexpr std::uint32_t kTimestampUICacheEnd     = 1;
+    constexpr std::uint32_t kTimestampSceneScaledEnd = 2;
+    constexpr std::uint32_t kTimestampFrameEnd       = 3;
+    constexpr std::uint32_t kTimestampCount          = 4;
+
+    // NOTE Main render pass subpasses use their subpass index, see blk::record_subpass
+    constexpr std::uint32_t kStatisticsUICache       = 2;
+    constexpr std::uint32_t kStatisticsSceneScaled   = 3;
 }
 
 namespace blk::sample0
 {
-Sample::RenderPass::RenderPass(Engine& vkengine, VkFormat formatColor, VkFormat formatDepth)
+Sample::RenderPass::RenderPass(Engine& vkengine, VkFormat formatColor, VkFormat formatDepth, bool cached_ui)
     : ::blk::RenderPass(vkengine.mDevice)
 {
     // Pass 0 : Draw UI    (write depth)
     // Pass 1 : Draw Scene (read depth, write color)
-    //  Depth discarded
+    //  Depth discarded, unless cached_ui where it is loaded and kept for next frames
     //  Color kept
     //  Transition to VK_IMAGE_LAYOUT_PRESENT_SRC_KHR to optimize transition before presentation
     const std::array attachments{
@@ -56,9 +70,9 @@ Sample::RenderPass::RenderPass(Engine& vkengine, VkFormat formatColor, VkFormat
             .samples        = VK_SAMPLE_COUNT_1_BIT,
             .loadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
             .storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-            .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_CLEAR,
-            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+            .stencilLoadOp  = cached_ui ? VK_ATTACHMENT_LOAD_OP_LOAD   : VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .stencilStoreOp = cached_ui ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout  = cached_ui ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED,
             .finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
         },
     };
@@ -134,11 +148,12 @@ Sample::RenderPass::RenderPass(Engine& vkengine, VkFormat formatColor, VkFormat
     CHECK(create(info));
 }
 
-Sample::Sample(blk::Engine& vkengine, VkFormat formatColor, const std::span<VkImage>& backbufferimages, const VkExtent2D& resolution)
+Sample::Sample(blk::Engine& vkengine, VkFormat formatColor, VkImageUsageFlags usageColor, const std::span<VkImage>& backbufferimages, const VkExtent2D& resolution)
     : mEngine(vkengine)
     , mDevice(vkengine.mDevice)
 
     , mColorFormat(formatColor)
+    , mColorUsage(usageColor)
     , mDepthFormat([&vkengine]{
         auto finder = std::ranges::find_if(
             kPreferredDepthFormats,
@@ -154,15 +169,17 @@ Sample::Sample(blk::Engine& vkengine, VkFormat formatColor, const std::span<VkIm
     }())
 
     , mResolution(resolution)
+    , mAttachmentExtent(bucket_extent(resolution))
 
     , mRenderPass(vkengine, mColorFormat, mDepthFormat)
+    , mCachedUIRenderPass(vkengine, mColorFormat, mDepthFormat, true)
 
-    , mMultipass(mRenderPass, PassUIOverlay::Arguments{ vkengine, resolution }, PassScene::Arguments{ vkengine, resolution })
+    , mMultipass(mRenderPass, PassUIOverlay::Arguments{ vkengine, resolution, mColorFormat, mDepthFormat }, PassScene::Arguments{ vkengine, resolution, mColorFormat })
     , mPassUIOverlay(subpass<0>(mMultipass))
     , mPassScene(subpass<1>(mMultipass))
 
     , mDepthImage(
-        VkExtent3D{ .width = mResolution.width, .height = mResolution.height, .depth = 1 },
+        VkExtent3D{ .width = mAttachmentExtent.width, .height = mAttachmentExtent.height, .depth = 1 },
         VK_IMAGE_TYPE_2D,
         mDepthFormat,
         VK_SAMPLE_COUNT_1_BIT,
@@ -171,12 +188,15 @@ Sample::Sample(blk::Engine& vkengine, VkFormat formatColor, const std::span<VkIm
         VK_IMAGE_LAYOUT_UNDEFINED
     )
 
-    , mRenderSemaphores(backbufferimages.size(), VK_NULL_HANDLE)
-    , mBackBufferViews(backbufferimages.size(), VK_NULL_HANDLE)
-    , mFrameBuffers(backbufferimages.size(), VK_NULL_HANDLE)
+    , mFramebufferCache(vkengine)
+
+    , mTimestamps(vkengine, kTimestampCount)
+    , mCalibration(vkengine)
+    , mPipelineStatistics(vkengine, static_cast<std::uint32_t>(kPipelineStatisticsPasses.size()))
 {
+    static_assert(multipass_type::kCount == kStatisticsUICache, "subpass queries come first");
     {// Resources
-        mDepthImage.create(mDevice);
+        mDepthImage.create(mDevice, "Depth");
     }
     {// Memories
         auto vkphysicaldevice = *(mDevice.mPhysicalDevice);
@@ -184,7 +204,7 @@ Sample::Sample(blk::Engine& vkengine, VkFormat formatColor, const std::span<VkIm
         auto memory_type = vkphysicaldevice.mMemories.find_compatible(mDepthImage, 0/*VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT*/);
         assert(memory_type);
         mDepthMemory = std::make_unique<blk::Memory>(*memory_type, mDepthImage.mRequirements.size);
-        mDepthMemory->allocate(mDevice);
+        mDepthMemory->allocate(mDevice, "Depth");
         mDepthMemory->bind(mDepthImage);
     }
     {// Image Views
@@ -195,66 +215,12 @@ Sample::Sample(blk::Engine& vkengine, VkFormat formatColor, const std::span<VkIm
                 mDepthFormat,
                 VK_IMAGE_ASPECT_STENCIL_BIT
             );
-            mDepthImageView.create(mDevice);
+            mDepthImageView.create(mDevice, "Depth");
         }
+        mPassUIOverlay.recreate_cache(mDepthImageView);
     }
-    {// Framebuffers
-        const VkSemaphoreTypeCreateInfo info_semaphore_type{
-            .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
-            .pNext         = nullptr,
-            .semaphoreType = VK_SEMAPHORE_TYPE_BINARY,
-            .initialValue  = 0,
-        };
-        const VkSemaphoreCreateInfo info_semaphore{
-            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
-            .pNext = &info_semaphore_type,
-            .flags = 0,
-        };
-        for (auto&& [image, view, framebuffer, render_semaphore] : ranges::views::zip(backbufferimages, mBackBufferViews, mFrameBuffers, mRenderSemaphores))
-        {
-            const VkImageViewCreateInfo info_imageview{
-                .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-                .pNext            = nullptr,
-                .flags            = 0,
-                .image            = image,
-                .viewType         = VK_IMAGE_VIEW_TYPE_2D,
-                .format           = formatColor,
-                .components       = VkComponentMapping{
-                    .r = VK_COMPONENT_SWIZZLE_R,
-                    .g = VK_COMPONENT_SWIZZLE_G,
-                    .b = VK_COMPONENT_SWIZZLE_B,
-                    .a = VK_COMPONENT_SWIZZLE_A,
-                },
-                .subresourceRange = VkImageSubresourceRange{
-                    .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .baseMipLevel   = 0,
-                    .levelCount     = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount     = 1,
-                },
-            };
-            CHECK(vkCreateImageView(mDevice, &info_imageview, nullptr, &view));
-            
-            const std::array attachments{
-                view,
-                // NOTE(andrea.machizaud) Is it safe to re-use depth here ?
-                (VkImageView)mDepthImageView
-            };
-            const VkFramebufferCreateInfo info_framebuffer{
-                .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-                .pNext           = nullptr,
-                .flags           = 0u,
-                .renderPass      = mRenderPass,
-                .attachmentCount = attachments.size(),
-                .pAttachments    = attachments.data(),
-                .width           = mResolution.width,
-                .height          = mResolution.height,
-                .layers          = 1,
-            };
-            CHECK(vkCreateFramebuffer(mDevice, &info_framebuffer, nullptr, &framebuffer));
-        
-            CHECK(vkCreateSemaphore(mDevice, &info_semaphore, nullptr, &render_semaphore));
-        }
+    {// Back buffers
+        recreate_backbuffers(formatColor, usageColor, backbufferimages);
     }
 }
 
@@ -263,31 +229,49 @@ Sample::~Sample()
     for(auto&& vksemaphore : mRenderSemaphores)
         vkDestroySemaphore(mDevice, vksemaphore, nullptr);
 
-    for(auto&& vkframebuffer : mFrameBuffers)
-        vkDestroyFramebuffer(mDevice, vkframebuffer, nullptr);
-
     for(auto&& view : mBackBufferViews)
         vkDestroyImageView(mDevice, view, nullptr);
 }
 
-void Sample::onIdle()
+bool Sample::need_frame() const
+{
+    return mPassUIOverlay.need_imgui_frame() || mPassScene.mPipeline.pending();
+}
+
+bool Sample::onIdle()
 {
+    BLK_PROFILE_ZONE("Sample::onIdle");
+    // NOTE Previous draw data, and its uploaded geometry, remain valid until the next ImGui frame
+    if (!mPassUIOverlay.need_imgui_frame())
+        return mPassScene.mPipeline.pending();
+
     mPassUIOverlay.render_imgui_frame();
     mPassUIOverlay.upload_imgui_draw_data();
+    return true;
 }
 
 void Sample::onResize(const VkExtent2D& resolution)
 {
     mResolution = resolution;
-    recreate_depth();
+    // NOTE Framebuffers are re-created anyway, attachments only when the extent leaves its bucket
+    if (const VkExtent2D extent = bucket_extent(resolution); !same_extent(extent, mAttachmentExtent))
+    {
+        mAttachmentExtent = extent;
+        recreate_depth();
+    }
     mPassUIOverlay.onResize(resolution);
     mPassScene.onResize(resolution);
+    mPassUIOverlay.recreate_cache(mDepthImageView);
 }
 
 void Sample::recreate_depth()
 {
+    mFramebufferCache.forget(mDepthImageView);
+    // NOTE Latest frame may still use them
+    mEngine.mRetireQueue.retire_objects(std::move(mDepthImageView), std::move(mDepthImage), std::move(mDepthMemory));
+
     mDepthImage = blk::Image(
-        VkExtent3D{ .width = mResolution.width, .height = mResolution.height, .depth = 1 },
+        VkExtent3D{ .width = mAttachmentExtent.width, .height = mAttachmentExtent.height, .depth = 1 },
         VK_IMAGE_TYPE_2D,
         mDepthFormat,
         VK_SAMPLE_COUNT_1_BIT,
@@ -295,10 +279,15 @@ void Sample::recreate_depth()
         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
         VK_IMAGE_LAYOUT_UNDEFINED
     );
-    mDepthImage.create(mDevice);
-
-    mDepthMemory->reallocate(mDevice, mDepthImage.mRequirements.size);
-    mDepthMemory->bind(mDepthImage);
+    mDepthImage.create(mDevice, "Depth");
+    {// Memory
+        const auto& vkphysicaldevice = *(mDevice.mPhysicalDevice);
+        auto memory_type = vkphysicaldevice.mMemories.find_compatible(mDepthImage, 0);
+        assert(memory_type);
+        mDepthMemory = std::make_unique<blk::Memory>(*memory_type, mDepthImage.mRequirements.size);
+        mDepthMemory->allocate(mDevice, "Depth");
+        mDepthMemory->bind(mDepthImage);
+    }
 
     mDepthImageView = blk::ImageView(
         mDepthImage,
@@ -306,19 +295,31 @@ void Sample::recreate_depth()
         mDepthFormat,
         VK_IMAGE_ASPECT_STENCIL_BIT
     );
-    mDepthImageView.create(mDevice);
+    mDepthImageView.create(mDevice, "Depth");
 }
 
-void Sample::recreate_backbuffers(VkFormat formatColor, const std::span<VkImage>& backbufferimages)
+void Sample::recreate_backbuffers(VkFormat formatColor, VkImageUsageFlags usageColor, const std::span<VkImage>& backbufferimages)
 {
-    for(auto&& vksemaphore : mRenderSemaphores)
-        vkDestroySemaphore(mDevice, vksemaphore, nullptr);
-
-    for(auto&& vkframebuffer : mFrameBuffers)
-        vkDestroyFramebuffer(mDevice, vkframebuffer, nullptr);
-
     for(auto&& view : mBackBufferViews)
-        vkDestroyImageView(mDevice, view, nullptr);
+        mFramebufferCache.forget(view);
+
+    // NOTE Latest frame may still use them
+    //  Its fence does not cover the presentation engine waiting on the render semaphore, only an idle queue does
+    mEngine.mRetireQueue.retire(
+        [device = static_cast<VkDevice>(mDevice), queue = static_cast<VkQueue>(*mEngine.mPresentationQueues.at(0)), semaphores = mRenderSemaphores, views = mBackBufferViews]{
+            CHECK(vkQueueWaitIdle(queue));
+            for(auto&& vksemaphore : semaphores)
+                vkDestroySemaphore(device, vksemaphore, nullptr);
+
+            for(auto&& view : views)
+                vkDestroyImageView(device, view, nullptr);
+        }
+    );
+
+    mColorUsage = usageColor;
+    // NOTE Swapchain image count may change (e.g. present policy)
+    mRenderSemaphores.assign(backbufferimages.size(), VK_NULL_HANDLE);
+    mBackBufferViews.assign(backbufferimages.size(), VK_NULL_HANDLE);
 
     const VkSemaphoreTypeCreateInfo info_semaphore_type{
         .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
@@ -331,7 +332,7 @@ void Sample::recreate_backbuffers(VkFormat formatColor, const std::span<VkImage>
         .pNext = &info_semaphore_type,
         .flags = 0,
     };
-    for (auto&& [image, view, framebuffer, render_semaphore] : ranges::views::zip(backbufferimages, mBackBufferViews, mFrameBuffers, mRenderSemaphores))
+    for (auto&& [image, view, render_semaphore] : ranges::views::zip(backbufferimages, mBackBufferViews, mRenderSemaphores))
     {
         const VkImageViewCreateInfo info_imageview{
             .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -355,31 +356,13 @@ void Sample::recreate_backbuffers(VkFormat formatColor, const std::span<VkImage>
             },
         };
         CHECK(vkCreateImageView(mDevice, &info_imageview, nullptr, &view));
-        
-        const std::array attachments{
-            view,
-            // NOTE(andrea.machizaud) Is it safe to re-use depth here ?
-            (VkImageView)mDepthImageView
-        };
-        const VkFramebufferCreateInfo info_framebuffer{
-            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .pNext           = nullptr,
-            .flags           = 0u,
-            .renderPass      = mRenderPass,
-            .attachmentCount = attachments.size(),
-            .pAttachments    = attachments.data(),
-            .width           = mResolution.width,
-            .height          = mResolution.height,
-            .layers          = 1,
-        };
-        CHECK(vkCreateFramebuffer(mDevice, &info_framebuffer, nullptr, &framebuffer));
-    
         CHECK(vkCreateSemaphore(mDevice, &info_semaphore, nullptr, &render_semaphore));
     }
 }
 
 void Sample::record(std::uint32_t backbufferindex, VkCommandBuffer commandbuffer)
 {
+    BLK_PROFILE_ZONE("Sample::record");
     constexpr VkCommandBufferBeginInfo info{
         .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .pNext            = nullptr,
@@ -387,6 +370,49 @@ void Sample::record(std::uint32_t backbufferindex, VkCommandBuffer commandbuffer
         .pInheritanceInfo = nullptr,
     };
     CHECK(vkBeginCommandBuffer(commandbuffer, &info));
+
+    {// GPU Time
+        // NOTE Previous frame submission is complete, see FramePacer::begin_frame
+        if (mTimestamps.fetch())
+        {
+            mGPUTime = mTimestamps.elapsed(kTimestampFrameBegin, kTimestampFrameEnd);
+            mPassScene.mScaler.update(mGPUTime);
+
+            if constexpr (blk::profiler::kEnabled)
+            {// Unified CPU / GPU timeline
+                if (mCalibration.update())
+                {
+                    auto host = [this](std::uint32_t index) {
+                        return mCalibration.host(mTimestamps.mTimestamps[index]);
+                    };
+                    auto& profiler = blk::profiler::Profiler::instance();
+                    profiler.gpu_zone("GPU Frame"       , host(kTimestampFrameBegin)    , host(kTimestampFrameEnd)      , 0);
+                    profiler.gpu_zone("GPU UI Cache"    , host(kTimestampFrameBegin)    , host(kTimestampUICacheEnd)    , 1);
+                    profiler.gpu_zone("GPU Scene Scaled", host(kTimestampUICacheEnd)    , host(kTimestampSceneScaledEnd), 1);
+                    profiler.gpu_zone("GPU Main Pass"   , host(kTimestampSceneScaledEnd), host(kTimestampFrameEnd)      , 1);
+                }
+            }
+        }
+        mTimestamps.reset(commandbuffer);
+        mTimestamps.write(commandbuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, kTimestampFrameBegin);
+    }
+    {// Pipeline Statistics
+        auto& ui = mPassUIOverlay.mUI;
+        ui.pipeline_statistics = mPipelineStatistics.supported();
+        if (mPipelineStatistics.fetch())
+        {
+            ui.pass_statistics.clear();
+            for (std::uint32_t index = 0; index < kPipelineStatisticsPasses.size(); ++index)
+                ui.pass_statistics.push_back({ kPipelineStatisticsPasses[index], mPipelineStatistics.statistics(index) });
+        }
+        mPipelineStatistics.reset(commandbuffer);
+    }
+    {// Dynamic Resolution
+        auto& ui = mPassUIOverlay.mUI;
+        mPassScene.mScaler.mEnabled = ui.dynamic_resolution && mTimestamps.supported();
+        mPassScene.mScaler.mTarget  = ui.target_gpu_time;
+        mPassScene.mSharpness       = ui.upscale_sharpness;
+    }
     
     constexpr std::array kClearValues {
         VkClearValue {
@@ -408,7 +434,53 @@ void Sample::record(std::uint32_t backbufferindex, VkCommandBuffer commandbuffer
         },
         .extent = mResolution
     };
-    mMultipass.record(mFrameBuffers.at(backbufferindex), commandbuffer, renderArea, kClearValues);
+    // NOTE One framebuffer per extent when imageless, views are then bound when beginning the render pass
+    mFramebufferCache.collect();
+    const std::array<blk::FramebufferCache::Attachment, 2> attachments{
+        blk::FramebufferCache::Attachment{
+            .view   = mBackBufferViews.at(backbufferindex),
+            .format = mColorFormat,
+            .usage  = mColorUsage,
+            .extent = mResolution,
+        },
+        blk::FramebufferCache::Attachment{
+            .view   = mDepthImageView,
+            .format = mDepthFormat,
+            .usage  = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+            .extent = mAttachmentExtent,
+        },
+    };
+    const VkFramebuffer framebuffer = mFramebufferCache.acquire(mRenderPass, mResolution, attachments);
+    const std::array<VkImageView, 2> views{ attachments[0].view, attachments[1].view };
+
+    // NOTE Cached UI is rendered before the main render pass, which then loads its stencil
+    //  Offscreen passes are gathered from outside their render pass, statistics are then zero when skipped
+    blk::debug::begin_label(commandbuffer, kPipelineStatisticsPasses[kStatisticsUICache]);
+    mPipelineStatistics.begin(commandbuffer, kStatisticsUICache);
+    const bool cached_ui = mPassUIOverlay.update_cache(commandbuffer);
+    mPipelineStatistics.end(commandbuffer, kStatisticsUICache);
+    blk::debug::end_label(commandbuffer);
+    mTimestamps.write(commandbuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, kTimestampUICacheEnd);
+    // NOTE Scaled scene is rendered before the main render pass, which then upscales it under the UI
+    blk::debug::begin_label(commandbuffer, kPipelineStatisticsPasses[kStatisticsSceneScaled]);
+    mPipelineStatistics.begin(commandbuffer, kStatisticsSceneScaled);
+    mPassScene.update_offscreen(commandbuffer, kClearValues[0].color);
+    mPipelineStatistics.end(commandbuffer, kStatisticsSceneScaled);
+    blk::debug::end_label(commandbuffer);
+    mTimestamps.write(commandbuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, kTimestampSceneScaledEnd);
+    {// Statistics
+        auto& ui = mPassUIOverlay.mUI;
+        ui.gpu_timestamps = mTimestamps.supported();
+        ui.gpu_time       = mGPUTime;
+        ui.scene_extent   = mPassScene.mRenderExtent;
+    }
+    mMultipass.record(
+        framebuffer, commandbuffer, renderArea, kClearValues,
+        cached_ui ? static_cast<VkRenderPass>(mCachedUIRenderPass) : VK_NULL_HANDLE,
+        mFramebufferCache.imageless() ? std::span<const VkImageView>(views) : std::span<const VkImageView>(),
+        mPipelineStatistics.supported() ? &mPipelineStatistics : nullptr
+    );
+    mTimestamps.write(commandbuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, kTimestampFrameEnd);
     CHECK(vkEndCommandBuffer(commandbuffer));
 }
 
@@ -6,11 +6,14 @@
 #include "../vkrenderpass.hpp"
 
 #include "../vkimage.hpp"
+#include "../vkframebuffercache.hpp"
+#include "../vkqueries.hpp"
 
 #include "./vkpassscene.hpp"
 #include "./vkpassuioverlay.hpp"
 
 #include <span>
+#include <array>
 #include <memory>
 
 namespace blk
@@ -31,18 +34,23 @@ namespace blk::sample0
 
         struct RenderPass : ::blk::RenderPass
         {
-            RenderPass(Engine& vkengine, VkFormat formatColor, VkFormat formatDepth);
+            // NOTE cached_ui variant loads the stencil written by the UI cache, instead of clearing it
+            RenderPass(Engine& vkengine, VkFormat formatColor, VkFormat formatDepth, bool cached_ui = false);
         };
 
         Engine&                      mEngine;
         const Device&                mDevice;
           
         VkFormat                     mColorFormat;
+        VkImageUsageFlags            mColorUsage;
         VkFormat                     mDepthFormat;
           
         VkExtent2D                   mResolution;
+        // Extent-sized attachments are allocated to this rounded-up extent, see bucket_extent
+        VkExtent2D                   mAttachmentExtent;
           
         RenderPass                   mRenderPass;
+        RenderPass                   mCachedUIRenderPass;
         multipass_type               mMultipass;
           
         PassUIOverlay&               mPassUIOverlay;
@@ -55,20 +63,36 @@ namespace blk::sample0
 
         std::vector<VkSemaphore>     mRenderSemaphores;
         std::vector<VkImageView>     mBackBufferViews;
-        std::vector<VkFramebuffer>   mFrameBuffers;
+
+        blk::FramebufferCache        mFramebufferCache;
+
+        // Frame command buffer begin/end, fetched once the frame completed
+        blk::TimestampQueries        mTimestamps;
+        // GPU time of the latest completed frame, in milliseconds
+        float                        mGPUTime = 0.0f;
+        // Places frame timestamps on the CPU profiler timeline
+        blk::TimestampCalibration    mCalibration;
+        // One query per pass, main render pass subpasses first (by subpass index)
+        static constexpr std::array kPipelineStatisticsPasses{ PassUIOverlay::kName, PassScene::kName, "UI Cache", "Scene Scaled" };
+        blk::PipelineStatisticsQueries mPipelineStatistics;
 
         Sample(
             blk::Engine& vkengine,
             VkFormat formatColor,
+            VkImageUsageFlags usageColor,
             const std::span<VkImage>& backbufferimages,
             const VkExtent2D& resolution
         );
         ~Sample();
 
+        // NOTE Re-create the depth attachment for mAttachmentExtent
         void recreate_depth();
-        void recreate_backbuffers(VkFormat formatColor, const std::span<VkImage>& backbufferimages);
+        void recreate_backbuffers(VkFormat formatColor, VkImageUsageFlags usageColor, const std::span<VkImage>& backbufferimages);
 
-        void onIdle();
+        // Whether the content may change, i.e. onIdle is worth calling (and the frame rendering)
+        bool need_frame() const;
+        // Returns whether the content changed since the previous frame
+        bool onIdle();
         void onResize(const VkExtent2D& resolution);
         void onKeyPressed(std::uint32_t backbufferindex, VkCommandBuffer commandbuffer);
 
@@ -0,0 +1,69 @@
+#include <hash.hpp>
+
+#include <cstdlib>
+#include <cstddef>
+#include <cinttypes>
+
+#include <random>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+// content_hash must depend on the position of the data, e.g. reordered vertices are a different draw list
+//  Usage: vkplaygrounds-test-hash
+
+namespace
+{
+    constexpr std::size_t kStripeSize = detail::hash::kStripeSize;
+    constexpr std::size_t kBlockSize  = detail::hash::kStripesPerBlock * kStripeSize;
+
+    int sFailures = 0;
+
+    void expect_different(const char* name, const std::vector<std::byte>& lhs, const std::vector<std::byte>& rhs)
+    {
+        if (content_hash(lhs.data(), lhs.size()) != content_hash(rhs.data(), rhs.size()))
+            return;
+
+        std::cerr << "FAILED " << name << ": same hash" << std::endl;
+        ++sFailures;
+    }
+
+    std::vector<std::byte> swapped(std::vector<std::byte> bytes, std::size_t lhs, std::size_t rhs, std::size_t size)
+    {
+        std::swap_ranges(std::begin(bytes) + lhs, std::begin(bytes) + lhs + size, std::begin(bytes) + rhs);
+        return bytes;
+    }
+}
+
+int main()
+{
+    std::vector<std::byte> bytes(4 * kBlockSize + kStripeSize / 2);
+    {// Random content, distinct stripes
+        std::mt19937_64 generator(42);
+        std::ranges::generate(bytes, [&generator]{ return static_cast<std::byte>(generator()); });
+    }
+
+    expect_different("swapped stripes, same block"   , bytes, swapped(bytes, 0, kStripeSize, kStripeSize));
+    expect_different("swapped stripes, across blocks", bytes, swapped(bytes, kStripeSize, kBlockSize + kStripeSize, kStripeSize));
+    expect_different("swapped blocks"                , bytes, swapped(bytes, 0, kBlockSize, kBlockSize));
+    expect_different("swapped stripe and remainder"  , bytes, swapped(bytes, 0, 4 * kBlockSize, kStripeSize / 2));
+
+    {// Same stripe repeated, only positions differ
+        std::vector<std::byte> repeated(2 * kBlockSize);
+        for (std::size_t idx = 0; idx < repeated.size(); ++idx)
+            repeated[idx] = static_cast<std::byte>(idx % kStripeSize);
+
+        std::vector<std::byte> longer(repeated);
+        longer.resize(repeated.size() + kStripeSize);
+        std::copy_n(std::begin(repeated), kStripeSize, std::begin(longer) + repeated.size());
+        expect_different("repeated stripe appended", repeated, longer);
+    }
+
+    if (content_hash(bytes.data(), bytes.size()) != content_hash(bytes.data(), bytes.size()))
+    {
+        std::cerr << "FAILED deterministic: different hashes" << std::endl;
+        ++sFailures;
+    }
+
+    return (sFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
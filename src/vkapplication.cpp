@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include <algorithm>
+#include <string_view>
 
 #include <array>
 
@@ -10,6 +11,8 @@
 #include <iostream>
 
 #include "./vkdebug.hpp"
+#include "./vkdebugutils.hpp"
+#include "./vkperformancewarnings.hpp"
 #include "./vkapplication.hpp"
 
 namespace
@@ -24,7 +27,7 @@ namespace
     };
 }
 
-VulkanApplication::VulkanApplication(Version version)
+VulkanApplication::VulkanApplication(Version version, bool validation, bool best_practices)
     : mVersion(version)
 {
     { // Layers / Extensions
@@ -47,6 +50,39 @@ VulkanApplication::VulkanApplication(Version version)
             CHECK(vkEnumerateInstanceExtensionProperties(layer_properties.layerName, &count, layer_extensions.data()));
         }
     }
+    { // Enabled Layers / Extensions
+        // NOTE Only what the loader advertises, e.g. no win32 surface off Windows, no validation layer on a bare driver install
+        if (validation)
+        {
+            for (auto&& layer : kLayers)
+            {
+                const bool available = std::any_of(
+                    std::begin(mLayers), std::end(mLayers),
+                    [layer](const VkLayerProperties& properties) {
+                        return std::string_view(layer) == properties.layerName;
+                    }
+                );
+                if (available)
+                    mEnabledLayers.push_back(layer);
+            }
+        }
+        for (auto&& extension : kExtensions)
+        {
+            if (has_extension(mExtensions, extension))
+                mEnabledExtensions.push_back(extension);
+        }
+        mDebugUtils = has_extension(mExtensions, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        #if defined(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME)
+        // NOTE Provided by the validation layer itself
+        if (best_practices && mDebugUtils && !mEnabledLayers.empty())
+        {
+            auto finder = mLayerExtensions.find(kLayers[0]);
+            mBestPractices = (finder != std::end(mLayerExtensions)) && has_extension(finder->second, VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+            if (mBestPractices)
+                mEnabledExtensions.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+        }
+        #endif
+    }
     { // Instance
         const VkApplicationInfo info_application{
             .sType              = VK_STRUCTURE_TYPE_APPLICATION_INFO,
@@ -84,25 +120,44 @@ VulkanApplication::VulkanApplication(Version version)
                 // | VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT
                 | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
                 | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+            // NOTE Performance messages are left to blk::PerformanceWarnings, see mPerformanceMessenger
             .messageType     = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT
-                | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT
-                | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+                | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT,
             .pfnUserCallback = StandardErrorDebugCallback,
             .pUserData       = nullptr,
         };
+        #if defined(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME)
+        constexpr const VkValidationFeatureEnableEXT kEnabledFeatures[] = {
+            VK_VALIDATION_FEATURE_ENABLE_BEST_PRACTICES_EXT,
+        };
+        const VkValidationFeaturesEXT info_features{
+            .sType                          = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT,
+            .pNext                          = mDebugUtils ? &info_debug : nullptr,
+            .enabledValidationFeatureCount  = sizeof(kEnabledFeatures) / sizeof(*kEnabledFeatures),
+            .pEnabledValidationFeatures     = kEnabledFeatures,
+            .disabledValidationFeatureCount = 0,
+            .pDisabledValidationFeatures    = nullptr,
+        };
+        const void* info_next = mBestPractices ? static_cast<const void*>(&info_features) : (mDebugUtils ? &info_debug : nullptr);
+        #else
+        const void* info_next = mDebugUtils ? &info_debug : nullptr;
+        #endif
         const VkInstanceCreateInfo info_instance{
             .sType                   = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
-            .pNext                   = &info_debug,
+            .pNext                   = info_next,
             .flags                   = 0,
             .pApplicationInfo        = &info_application,
-            .enabledLayerCount       = kLayers.size(),
-            .ppEnabledLayerNames     = kLayers.data(),
-            .enabledExtensionCount   = kExtensions.size(),
-            .ppEnabledExtensionNames = kExtensions.data(),
+            .enabledLayerCount       = static_cast<std::uint32_t>(mEnabledLayers.size()),
+            .ppEnabledLayerNames     = mEnabledLayers.data(),
+            .enabledExtensionCount   = static_cast<std::uint32_t>(mEnabledExtensions.size()),
+            .ppEnabledExtensionNames = mEnabledExtensions.data(),
         };
         CHECK(vkCreateInstance(&info_instance, nullptr, &mInstance));
     }
+    if (mDebugUtils)
     {
+        blk::debug::load(mInstance);
+
         auto vkCreateDebugUtilsMessengerEXT = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>(vkGetInstanceProcAddr(mInstance, "vkCreateDebugUtilsMessengerEXT"));
         {
             const VkDebugUtilsMessengerCreateInfoEXT info{
@@ -112,9 +167,9 @@ VulkanApplication::VulkanApplication(Version version)
                 .messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT
                     | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
                     | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+                // NOTE Performance messages are gathered by mPerformanceMessenger, then summarized on exit
                 .messageType     = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT
-                    | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT
-                    | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+                    | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT,
                 .pfnUserCallback = StandardErrorDebugCallback,
                 .pUserData       = nullptr,
             };
@@ -127,23 +182,44 @@ VulkanApplication::VulkanApplication(Version version)
                 .flags           = 0,
                 .messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
                     | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+                // NOTE Performance messages only reach blk::PerformanceWarnings, see mPerformanceMessenger
                 .messageType     = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT
-                    | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT
-                    | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+                    | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT,
                 .pfnUserCallback = DebuggerCallback,
                 .pUserData       = nullptr,
             };
             CHECK(vkCreateDebugUtilsMessengerEXT(mInstance, &info, nullptr, &mDebuggerMessenger));
         }
+        {
+            const VkDebugUtilsMessengerCreateInfoEXT info{
+                .sType           = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT,
+                .pNext           = nullptr,
+                .flags           = 0,
+                .messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT
+                    | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
+                    | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+                .messageType     = VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+                .pfnUserCallback = blk::PerformanceWarnings::callback,
+                .pUserData       = &blk::PerformanceWarnings::instance(),
+            };
+            CHECK(vkCreateDebugUtilsMessengerEXT(mInstance, &info, nullptr, &mPerformanceMessenger));
+        }
     }
 }
 
 VulkanApplication::~VulkanApplication()
 {
+    if (mDebugUtils)
     {
         auto vkDestroyDebugUtilsMessengerEXT = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(vkGetInstanceProcAddr(mInstance, "vkDestroyDebugUtilsMessengerEXT"));
         vkDestroyDebugUtilsMessengerEXT(mInstance, mDebuggerMessenger, nullptr);
         vkDestroyDebugUtilsMessengerEXT(mInstance, mStandardErrorMessenger, nullptr);
+        vkDestroyDebugUtilsMessengerEXT(mInstance, mPerformanceMessenger, nullptr);
+
+        if (const auto& collector = blk::PerformanceWarnings::instance(); !collector.warnings().empty())
+            collector.report(std::cerr);
+
+        blk::debug::unload();
     }
     vkDestroyInstance(mInstance, nullptr);
 }
@@ -12,7 +12,9 @@
 
 struct VulkanApplication
 {
-    explicit VulkanApplication(Version version);
+    // NOTE validation enables the Khronos validation layer, when installed
+    //  best_practices additionally enables its best practices checks, reported through blk::PerformanceWarnings
+    explicit VulkanApplication(Version version, bool validation = true, bool best_practices = false);
     ~VulkanApplication();
 
     operator VkInstance() const
@@ -25,7 +27,16 @@ struct VulkanApplication
     std::vector<VkExtensionProperties>                                       mExtensions;
     std::unordered_map<std::string_view, std::vector<VkExtensionProperties>> mLayerExtensions;
 
+    std::vector<const char*>                                                 mEnabledLayers;
+    std::vector<const char*>                                                 mEnabledExtensions;
+    // VK_EXT_debug_utils messengers are installed
+    bool                                                                     mDebugUtils = false;
+    // VK_EXT_validation_features best practices checks are enabled
+    bool                                                                     mBestPractices = false;
+
     VkInstance               mInstance               = VK_NULL_HANDLE;
     VkDebugUtilsMessengerEXT mDebuggerMessenger      = VK_NULL_HANDLE;
     VkDebugUtilsMessengerEXT mStandardErrorMessenger = VK_NULL_HANDLE;
+    // Performance messages, see blk::PerformanceWarnings
+    VkDebugUtilsMessengerEXT mPerformanceMessenger   = VK_NULL_HANDLE;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "./vkdebug.hpp"
+#include "./vkdebugutils.hpp"
 
 #include <vulkan/vulkan_core.h>
 
@@ -20,6 +21,8 @@ namespace blk
         Memory*              mMemory       = nullptr;
         std::uint32_t        mOffset       = ~0;
         std::uint32_t        mOccupied     = ~0;
+        // See create
+        const char*          mName         = nullptr;
 
         constexpr Buffer() = default;
 
@@ -33,6 +36,7 @@ namespace blk
             , mMemory(std::exchange(rhs.mMemory, nullptr))
             , mOffset(std::exchange(rhs.mOffset, ~0))
             , mOccupied(std::exchange(rhs.mOccupied, ~0))
+            , mName(std::exchange(rhs.mName, nullptr))
         {
         }
 
@@ -71,14 +75,18 @@ namespace blk
             mMemory       = std::exchange(rhs.mMemory      , mMemory);
             mOffset       = std::exchange(rhs.mOffset      , mOffset);
             mOccupied     = std::exchange(rhs.mOccupied    , mOccupied);
+            mName         = std::exchange(rhs.mName        , mName);
             return *this;
         }
 
-        VkResult create(VkDevice vkdevice)
+        // name is recorded for debuggers (see blk::debug::name) and blk::MemoryTracer, i.e. a string literal
+        VkResult create(VkDevice vkdevice, const char* name = nullptr)
         {
             mDevice = vkdevice;
+            mName   = name;
             auto result = vkCreateBuffer(mDevice, &mInfo, nullptr, &mBuffer);
             CHECK(result);
+            debug::name(mDevice, mBuffer, name);
             vkGetBufferMemoryRequirements(mDevice, mBuffer, &mRequirements);
             return result;
         }
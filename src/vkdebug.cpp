@@ -1,5 +1,3 @@
-#include <windows.h>
-
 #include <vulkan/vulkan.h>
 
 #include <cassert>
@@ -0,0 +1,73 @@
+#include "./vkdebugutils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cinttypes>
+
+#if defined(BLK_DEBUG_UTILS)
+
+namespace
+{
+    PFN_vkSetDebugUtilsObjectNameEXT sSetDebugUtilsObjectName = nullptr;
+    PFN_vkCmdBeginDebugUtilsLabelEXT sCmdBeginDebugUtilsLabel = nullptr;
+    PFN_vkCmdEndDebugUtilsLabelEXT   sCmdEndDebugUtilsLabel   = nullptr;
+}
+
+namespace blk::debug
+{
+
+void load(VkInstance vkinstance)
+{
+    sSetDebugUtilsObjectName = reinterpret_cast<PFN_vkSetDebugUtilsObjectNameEXT>(vkGetInstanceProcAddr(vkinstance, "vkSetDebugUtilsObjectNameEXT"));
+    sCmdBeginDebugUtilsLabel = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(vkGetInstanceProcAddr(vkinstance, "vkCmdBeginDebugUtilsLabelEXT"));
+    sCmdEndDebugUtilsLabel   = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>  (vkGetInstanceProcAddr(vkinstance, "vkCmdEndDebugUtilsLabelEXT"));
+}
+
+void unload()
+{
+    sSetDebugUtilsObjectName = nullptr;
+    sCmdBeginDebugUtilsLabel = nullptr;
+    sCmdEndDebugUtilsLabel   = nullptr;
+}
+
+void name(VkDevice vkdevice, VkObjectType type, std::uint64_t handle, const char* name)
+{
+    if ((sSetDebugUtilsObjectName == nullptr) || (name == nullptr) || (handle == 0))
+        return;
+
+    const VkDebugUtilsObjectNameInfoEXT info{
+        .sType        = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+        .pNext        = nullptr,
+        .objectType   = type,
+        .objectHandle = handle,
+        .pObjectName  = name,
+    };
+    // NOTE Names are copied, failure only loses a name
+    sSetDebugUtilsObjectName(vkdevice, &info);
+}
+
+void begin_label(VkCommandBuffer vkcmdbuffer, const char* name)
+{
+    if (sCmdBeginDebugUtilsLabel == nullptr)
+        return;
+
+    const VkDebugUtilsLabelEXT info{
+        .sType      = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+        .pNext      = nullptr,
+        .pLabelName = name,
+        .color      = { 0.0f, 0.0f, 0.0f, 0.0f },
+    };
+    sCmdBeginDebugUtilsLabel(vkcmdbuffer, &info);
+}
+
+void end_label(VkCommandBuffer vkcmdbuffer)
+{
+    if (sCmdEndDebugUtilsLabel == nullptr)
+        return;
+
+    sCmdEndDebugUtilsLabel(vkcmdbuffer);
+}
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cinttypes>
+
+// Object names and command buffer labels through VK_EXT_debug_utils, shown by validation messages and frame debuggers (e.g. RenderDoc)
+//  NOTE Compiled out unless BLK_DEBUG_UTILS is defined, see ENABLE_DEBUG_UTILS
+//  NOTE No-op at runtime until entry points are loaded, i.e. when the instance did not enable the extension
+namespace blk::debug
+{
+    #if defined(BLK_DEBUG_UTILS)
+    constexpr bool kEnabled = true;
+    #else
+    constexpr bool kEnabled = false;
+    #endif
+
+    #if defined(BLK_DEBUG_UTILS)
+    // Resolve entry points, see VulkanApplication
+    void load(VkInstance vkinstance);
+    void unload();
+
+    void name(VkDevice vkdevice, VkObjectType type, std::uint64_t handle, const char* name);
+
+    void begin_label(VkCommandBuffer vkcmdbuffer, const char* name);
+    void end_label(VkCommandBuffer vkcmdbuffer);
+    #else
+    inline void load(VkInstance) {}
+    inline void unload() {}
+
+    inline void name(VkDevice, VkObjectType, std::uint64_t, const char*) {}
+
+    inline void begin_label(VkCommandBuffer, const char*) {}
+    inline void end_label(VkCommandBuffer) {}
+    #endif
+
+    // NOTE Non-dispatchable handles are 64-bit integers on 32-bit platforms, overloads are then ambiguous
+    static_assert(sizeof(void*) == sizeof(std::uint64_t), "typed overloads require 64-bit handles");
+
+    inline void name(VkDevice vkdevice, VkBuffer vkbuffer, const char* name)
+    {
+        debug::name(vkdevice, VK_OBJECT_TYPE_BUFFER, reinterpret_cast<std::uint64_t>(vkbuffer), name);
+    }
+
+    inline void name(VkDevice vkdevice, VkImage vkimage, const char* name)
+    {
+        debug::name(vkdevice, VK_OBJECT_TYPE_IMAGE, reinterpret_cast<std::uint64_t>(vkimage), name);
+    }
+
+    inline void name(VkDevice vkdevice, VkImageView vkimageview, const char* name)
+    {
+        debug::name(vkdevice, VK_OBJECT_TYPE_IMAGE_VIEW, reinterpret_cast<std::uint64_t>(vkimageview), name);
+    }
+
+    inline void name(VkDevice vkdevice, VkDeviceMemory vkmemory, const char* name)
+    {
+        debug::name(vkdevice, VK_OBJECT_TYPE_DEVICE_MEMORY, reinterpret_cast<std::uint64_t>(vkmemory), name);
+    }
+
+    inline void name(VkDevice vkdevice, VkPipeline vkpipeline, const char* name)
+    {
+        debug::name(vkdevice, VK_OBJECT_TYPE_PIPELINE, reinterpret_cast<std::uint64_t>(vkpipeline), name);
+    }
+
+    inline void name(VkDevice vkdevice, VkCommandBuffer vkcmdbuffer, const char* name)
+    {
+        debug::name(vkdevice, VK_OBJECT_TYPE_COMMAND_BUFFER, reinterpret_cast<std::uint64_t>(vkcmdbuffer), name);
+    }
+
+    // Label region recorded for the lifetime of the scope
+    //  NOTE Regions must be closed within the command buffer they were opened in, and not straddle a render pass boundary
+    struct ScopedLabel
+    {
+        ScopedLabel(VkCommandBuffer vkcmdbuffer, const char* name)
+            : mCommandBuffer(vkcmdbuffer)
+        {
+            begin_label(mCommandBuffer, name);
+        }
+
+        ~ScopedLabel()
+        {
+            end_label(mCommandBuffer);
+        }
+
+        ScopedLabel(const ScopedLabel& rhs) = delete;
+        ScopedLabel& operator=(const ScopedLabel& rhs) = delete;
+
+        VkCommandBuffer mCommandBuffer;
+    };
+}
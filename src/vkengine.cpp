@@ -2,8 +2,11 @@
 
 #include "./vkutilities.hpp"
 #include "./vkdebug.hpp"
+#include "./vkdebugutils.hpp"
 #include "./vkqueue.hpp"
 #include "./vkphysicaldevice.hpp"
+#include "./vkprofiler.hpp"
+#include "./vkstartupprofiler.hpp"
 
 #include <vulkan/vulkan_core.h>
 
@@ -20,9 +23,11 @@
 #include <ranges>
 #include <numeric>
 #include <iterator>
+#include <utility>
 
 #include <array>
 #include <vector>
+#include <algorithm>
 
 namespace
 {
@@ -57,6 +62,7 @@ namespace
         .textureCompressionASTC_LDR              = VK_FALSE,
         .textureCompressionBC                    = VK_FALSE,
         .occlusionQueryPrecise                   = VK_FALSE,
+        // NOTE Enabled when supported, see Engine::Engine
         .pipelineStatisticsQuery                 = VK_FALSE,
         .vertexPipelineStoresAndAtomics          = VK_FALSE,
         .fragmentStoresAndAtomics                = VK_FALSE,
@@ -125,6 +131,7 @@ namespace
         .runtimeDescriptorArray                             = VK_FALSE,
         .samplerFilterMinmax                                = VK_FALSE,
         .scalarBlockLayout                                  = VK_FALSE,
+        // NOTE Enabled when supported, see Engine::mImagelessFramebuffer
         .imagelessFramebuffer                               = VK_FALSE,
         .uniformBufferStandardLayout                        = VK_FALSE,
         .shaderSubgroupExtendedTypes                        = VK_FALSE,
@@ -144,6 +151,13 @@ namespace
     constexpr std::array kEnabledExtensions{
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
     };
+
+    // NOTE Clock behind std::chrono::steady_clock, see blk::profiler::now
+    #if defined(OS_WINDOWS)
+    constexpr VkTimeDomainEXT kHostTimeDomain = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+    #else
+    constexpr VkTimeDomainEXT kHostTimeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+    #endif
 }
 
 namespace blk
@@ -168,7 +182,179 @@ Engine::Engine(
     , mStagingBuffer(kStagingBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
 {
     {// Device
+        const blk::StartupPhase phase("Device");
+        mEnabledExtensions.assign(std::begin(kEnabledExtensions), std::end(kEnabledExtensions));
+
+        VkPhysicalDeviceVulkan12Features vk12features = kVK12Features;
+        // Optional features, chained after Vulkan 1.2 ones
+        void* features_chain = nullptr;
+
+        {// Imageless Framebuffer (optional)
+            VkPhysicalDeviceVulkan12Features supported{
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+                .pNext = nullptr,
+            };
+            VkPhysicalDeviceFeatures2 features{
+                .sType    = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                .pNext    = &supported,
+                .features = {},
+            };
+            vkGetPhysicalDeviceFeatures2(mPhysicalDevice, &features);
+            mImagelessFramebuffer = (supported.imagelessFramebuffer == VK_TRUE);
+            vk12features.imagelessFramebuffer = supported.imagelessFramebuffer;
+        }
+
+        #if defined(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)
+        VkPhysicalDeviceHostImageCopyFeaturesEXT host_image_copy_features{
+            .sType         = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT,
+            .pNext         = nullptr,
+            .hostImageCopy = VK_FALSE,
+        };
+        {// Host Image Copy (optional)
+            constexpr std::array kHostImageCopyExtensions{
+                VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
+                VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME,
+                VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME,
+            };
+            const bool supported = std::ranges::all_of(
+                kHostImageCopyExtensions,
+                [this](const char* extension) {
+                    return has_extension(mPhysicalDevice.mExtensions, extension);
+                }
+            );
+            if (supported)
+            {
+                VkPhysicalDeviceFeatures2 features{
+                    .sType    = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                    .pNext    = &host_image_copy_features,
+                    .features = {},
+                };
+                vkGetPhysicalDeviceFeatures2(mPhysicalDevice, &features);
+            }
+            mHostImageCopy = supported && host_image_copy_features.hostImageCopy;
+            if (mHostImageCopy)
+            {
+                mEnabledExtensions.insert(std::end(mEnabledExtensions), std::begin(kHostImageCopyExtensions), std::end(kHostImageCopyExtensions));
+                host_image_copy_features.pNext = std::exchange(features_chain, &host_image_copy_features);
+            }
+        }
+        #endif
+
+        #if defined(VK_KHR_PRESENT_WAIT_EXTENSION_NAME) && defined(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+        VkPhysicalDevicePresentIdFeaturesKHR present_id_features{
+            .sType     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+            .pNext     = nullptr,
+            .presentId = VK_FALSE,
+        };
+        VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{
+            .sType       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+            .pNext       = nullptr,
+            .presentWait = VK_FALSE,
+        };
+        {// Present Wait (optional)
+            const bool supported = has_extension(mPhysicalDevice.mExtensions, VK_KHR_PRESENT_ID_EXTENSION_NAME)
+                && has_extension(mPhysicalDevice.mExtensions, VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+            if (supported)
+            {
+                present_id_features.pNext = &present_wait_features;
+                VkPhysicalDeviceFeatures2 features{
+                    .sType    = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                    .pNext    = &present_id_features,
+                    .features = {},
+                };
+                vkGetPhysicalDeviceFeatures2(mPhysicalDevice, &features);
+            }
+            mPresentWait = supported && present_id_features.presentId && present_wait_features.presentWait;
+            if (mPresentWait)
+            {
+                mEnabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+                mEnabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+                present_wait_features.pNext = std::exchange(features_chain, &present_id_features);
+            }
+        }
+        #endif
+
+        #if defined(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)
+        {// Calibrated Timestamps (optional)
+            std::vector<VkTimeDomainEXT> domains;
+            auto vkGetPhysicalDeviceCalibrateableTimeDomainsEXT = reinterpret_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT>(
+                vkGetInstanceProcAddr(mInstance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT")
+            );
+            if (has_extension(mPhysicalDevice.mExtensions, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) && vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)
+            {
+                std::uint32_t count = 0;
+                CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(mPhysicalDevice, &count, nullptr));
+                domains.resize(count);
+                CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(mPhysicalDevice, &count, domains.data()));
+            }
+            mCalibratedTimestamps = (std::ranges::find(domains, VK_TIME_DOMAIN_DEVICE_EXT) != std::ranges::end(domains))
+                && (std::ranges::find(domains, kHostTimeDomain) != std::ranges::end(domains));
+            if (mCalibratedTimestamps)
+            {
+                mHostTimeDomain = kHostTimeDomain;
+                mEnabledExtensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+            }
+        }
+        #endif
+
+        VkPhysicalDeviceFeatures features = kFeatures;
+        {// Pipeline Statistics Queries (optional)
+            mPipelineStatistics = (mPhysicalDevice.mFeatures.pipelineStatisticsQuery == VK_TRUE);
+            features.pipelineStatisticsQuery = mPhysicalDevice.mFeatures.pipelineStatisticsQuery;
+        }
+
+        vk12features.pNext = features_chain;
+
+        mDevice.mInfo.pNext                   = &vk12features;
+        mDevice.mInfo.pEnabledFeatures        = &features;
+        mDevice.mInfo.enabledExtensionCount   = static_cast<std::uint32_t>(mEnabledExtensions.size());
+        mDevice.mInfo.ppEnabledExtensionNames = mEnabledExtensions.data();
         mDevice.create();
+        // NOTE Features chain is only read at creation
+        mDevice.mInfo.pNext            = nullptr;
+        mDevice.mInfo.pEnabledFeatures = &kFeatures;
+
+        #if defined(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)
+        if (mHostImageCopy)
+        {
+            VkPhysicalDeviceHostImageCopyPropertiesEXT host_image_copy_properties{
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT,
+                .pNext = nullptr,
+            };
+            VkPhysicalDeviceProperties2 properties{
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                .pNext = &host_image_copy_properties,
+            };
+            // NOTE First call for layout counts, second one to fill them in
+            vkGetPhysicalDeviceProperties2(mPhysicalDevice, &properties);
+            mHostImageCopyLayouts.resize(host_image_copy_properties.copyDstLayoutCount);
+            host_image_copy_properties.copySrcLayoutCount = 0;
+            host_image_copy_properties.pCopySrcLayouts    = nullptr;
+            host_image_copy_properties.pCopyDstLayouts    = mHostImageCopyLayouts.data();
+            vkGetPhysicalDeviceProperties2(mPhysicalDevice, &properties);
+
+            mCopyMemoryToImage     = reinterpret_cast<PFN_vkCopyMemoryToImageEXT>(vkGetDeviceProcAddr(mDevice, "vkCopyMemoryToImageEXT"));
+            mTransitionImageLayout = reinterpret_cast<PFN_vkTransitionImageLayoutEXT>(vkGetDeviceProcAddr(mDevice, "vkTransitionImageLayoutEXT"));
+            mHostImageCopy = (mCopyMemoryToImage != nullptr) && (mTransitionImageLayout != nullptr);
+        }
+        #endif
+
+        #if defined(VK_KHR_PRESENT_WAIT_EXTENSION_NAME) && defined(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+        if (mPresentWait)
+        {
+            mWaitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(mDevice, "vkWaitForPresentKHR"));
+            mPresentWait = (mWaitForPresent != nullptr);
+        }
+        #endif
+
+        #if defined(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)
+        if (mCalibratedTimestamps)
+        {
+            mGetCalibratedTimestamps = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(vkGetDeviceProcAddr(mDevice, "vkGetCalibratedTimestampsEXT"));
+            mCalibratedTimestamps = (mGetCalibratedTimestamps != nullptr);
+        }
+        #endif
+
         const std::size_t queue_count = std::accumulate(
             std::begin(info_queues), std::end(info_queues),
             std::size_t{0},
@@ -239,6 +425,7 @@ Engine::Engine(
         mTransferQueues.shrink_to_fit();
     }
     {// Pipeline Cache
+        const blk::StartupPhase phase("Pipeline Cache");
         const VkPipelineCacheCreateInfo info{
             .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
             .pNext           = nullptr,
@@ -250,10 +437,9 @@ Engine::Engine(
         CHECK(vkCreatePipelineCache(mDevice, &info, nullptr, &mPipelineCache));
     }
     {// Pools
-        assert(!mTransferQueues.empty());
+        // NOTE No dedicated transfer queue is required, e.g. single family software rasterizers
         assert(!mGraphicsQueues.empty());
         assert(!mPresentationQueues.empty());
-        const blk::Queue* transfer_queue = mTransferQueues.at(0);
         const blk::Queue* graphic_queue = mGraphicsQueues.at(0);
         const blk::Queue* presentation_queue = mPresentationQueues.at(0);
         {// Command Pools
@@ -276,6 +462,7 @@ Engine::Engine(
         }
     }
     {// Staging
+        const blk::StartupPhase phase("Staging");
         {// Fences
             const VkFenceCreateInfo info{
                 .sType              = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
@@ -293,6 +480,7 @@ Engine::Engine(
                 .commandBufferCount = 1,
             };
             CHECK(vkAllocateCommandBuffers(mDevice, &info, &mStagingCommandBuffer));
+            blk::debug::name(mDevice, mStagingCommandBuffer, "Engine Staging");
         }
         {// Semaphores
             const VkSemaphoreTypeCreateInfo info_type{
@@ -309,19 +497,21 @@ Engine::Engine(
             CHECK(vkCreateSemaphore(mDevice, &info_semaphore, nullptr, &mStagingSemaphore));
         }
         // Buffer
-        mStagingBuffer.create(mDevice);
+        mStagingBuffer.create(mDevice, "Engine Staging");
 
         // Memory
         auto memory_type = vkphysicaldevice.mMemories.find_compatible(mStagingBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
         assert(memory_type);
         mStagingMemory = std::make_unique<blk::Memory>(*memory_type, mStagingBuffer.mRequirements.size);
-        mStagingMemory->allocate(mDevice);
+        mStagingMemory->allocate(mDevice, "Engine Staging");
         mStagingMemory->bind(mStagingBuffer);
     }
 }
 
 Engine::~Engine()
 {
+    mRetireQueue.flush();
+
     vkDestroySemaphore(mDevice, mStagingSemaphore, nullptr);
     vkDestroyFence(mDevice, mStagingFence, nullptr);
 
@@ -341,6 +531,7 @@ void Engine::submit(
         const std::span<const VkSemaphore>& vksignal_semaphores,
         VkFence vkfence)
 {
+    BLK_PROFILE_ZONE("Engine::submit");
     const std::array infos{
         VkSubmitInfo{
             .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
@@ -383,4 +574,80 @@ void Engine::wait_staging_operations()
 {
     vkWaitForFences(mDevice, 1, &mStagingFence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
 }
+
+bool Engine::supports_host_image_copy(VkFormat format, VkImageLayout layout) const
+{
+    if (!mHostImageCopy)
+        return false;
+
+    if (std::ranges::find(mHostImageCopyLayouts, layout) == std::ranges::end(mHostImageCopyLayouts))
+        return false;
+
+    #if defined(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)
+        VkFormatProperties3 properties3{
+            .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3,
+            .pNext = nullptr,
+        };
+        VkFormatProperties2 properties{
+            .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2,
+            .pNext = &properties3,
+        };
+        vkGetPhysicalDeviceFormatProperties2(mPhysicalDevice, format, &properties);
+        return (properties3.optimalTilingFeatures & VK_FORMAT_FEATURE_2_HOST_IMAGE_TRANSFER_BIT_EXT) != 0;
+    #else
+        return false;
+    #endif
+}
+
+void Engine::host_image_upload(const blk::Image& image, VkImageLayout layout, VkImageAspectFlags aspect, const void* texels) const
+{
+    assert(mHostImageCopy);
+    #if defined(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)
+        const VkHostImageLayoutTransitionInfoEXT transition{
+            .sType            = VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT,
+            .pNext            = nullptr,
+            .image            = image.mImage,
+            .oldLayout        = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout        = layout,
+            .subresourceRange = VkImageSubresourceRange{
+                .aspectMask     = aspect,
+                .baseMipLevel   = 0,
+                .levelCount     = 1,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+        };
+        CHECK(mTransitionImageLayout(mDevice, 1, &transition));
+
+        const VkMemoryToImageCopyEXT region{
+            .sType             = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT,
+            .pNext             = nullptr,
+            .pHostPointer      = texels,
+            .memoryRowLength   = 0,
+            .memoryImageHeight = 0,
+            .imageSubresource  = VkImageSubresourceLayers{
+                .aspectMask     = aspect,
+                .mipLevel       = 0,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+            .imageOffset       = VkOffset3D{
+                .x = 0,
+                .y = 0,
+                .z = 0,
+            },
+            .imageExtent       = image.mInfo.extent,
+        };
+        const VkCopyMemoryToImageInfoEXT info{
+            .sType          = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT,
+            .pNext          = nullptr,
+            .flags          = 0,
+            .dstImage       = image.mImage,
+            .dstImageLayout = layout,
+            .regionCount    = 1,
+            .pRegions       = &region,
+        };
+        CHECK(mCopyMemoryToImage(mDevice, &info));
+    #endif
+}
 }
@@ -19,6 +19,8 @@
 
 #include "./vkbuffer.hpp"
 #include "./vkimage.hpp"
+#include "./vkpipelinecompiler.hpp"
+#include "./vkretirequeue.hpp"
 
 namespace blk
 {
@@ -58,12 +60,43 @@ struct Engine
 
     void wait_staging_operations();
 
+    // VK_EXT_host_image_copy : whether optimal images of this format can be written from host memory in this layout
+    bool supports_host_image_copy(VkFormat format, VkImageLayout layout) const;
+    // Host side upload of tightly packed texels into the whole image (first mip level, first layer)
+    //  Image is transitioned from VK_IMAGE_LAYOUT_UNDEFINED into layout, no device access must be pending
+    void host_image_upload(const blk::Image& image, VkImageLayout layout, VkImageAspectFlags aspect, const void* texels) const;
+
     VkInstance                                mInstance                = VK_NULL_HANDLE;
     VkSurfaceKHR                              mSurface                 = VK_NULL_HANDLE;
     const blk::PhysicalDevice&                mPhysicalDevice;
      
     blk::Device                               mDevice;
      
+    // Device extensions, optional ones are enabled when supported
+    std::vector<const char*>                  mEnabledExtensions;
+    bool                                      mHostImageCopy           = false;
+    // Layouts supported as destination of host image copies
+    std::vector<VkImageLayout>                mHostImageCopyLayouts;
+#if defined(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)
+    PFN_vkCopyMemoryToImageEXT                mCopyMemoryToImage       = nullptr;
+    PFN_vkTransitionImageLayoutEXT            mTransitionImageLayout   = nullptr;
+#endif
+    // VK_KHR_present_id + VK_KHR_present_wait
+    bool                                      mPresentWait             = false;
+    // Framebuffers only describe attachments, views are provided when beginning the render pass
+    bool                                      mImagelessFramebuffer    = false;
+#if defined(VK_KHR_PRESENT_WAIT_EXTENSION_NAME) && defined(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+    PFN_vkWaitForPresentKHR                   mWaitForPresent          = nullptr;
+#endif
+    // VK_QUERY_TYPE_PIPELINE_STATISTICS queries, see blk::PipelineStatisticsQueries
+    bool                                      mPipelineStatistics      = false;
+    // VK_EXT_calibrated_timestamps, device timestamps can be sampled along with mHostTimeDomain, i.e. std::chrono::steady_clock
+    bool                                      mCalibratedTimestamps    = false;
+    VkTimeDomainEXT                           mHostTimeDomain          = VK_TIME_DOMAIN_DEVICE_EXT;
+#if defined(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)
+    PFN_vkGetCalibratedTimestampsEXT          mGetCalibratedTimestamps = nullptr;
+#endif
+     
     std::vector<blk::Queue>                   mQueues;
     std::vector<blk::Queue*>                  mSparseQueues;
     std::vector<blk::Queue*>                  mComputeQueues;
@@ -72,6 +105,9 @@ struct Engine
     std::vector<blk::Queue*>                  mPresentationQueues;
      
     VkPipelineCache                           mPipelineCache           = VK_NULL_HANDLE;
+    blk::PipelineCompiler                     mPipelineCompiler;
+    // Objects replaced while in use by in-flight frames, see FramePacer
+    blk::RetireQueue                          mRetireQueue;
      
     VkCommandPool                             mComputeCommandPool      = VK_NULL_HANDLE;
     VkCommandPool                             mTransferCommandPool     = VK_NULL_HANDLE;
@@ -83,8 +119,6 @@ struct Engine
     VkSemaphore                               mStagingSemaphore        = VK_NULL_HANDLE;
     VkCommandBuffer                           mStagingCommandBuffer    = VK_NULL_HANDLE;
     std::unique_ptr<blk::Memory>              mStagingMemory;
-
-    std::vector<std::unique_ptr<blk::Memory>> mMemoryChunks;
 };
 
 }
@@ -0,0 +1,166 @@
+#include "./vkframebuffercache.hpp"
+
+#include "./vkdebug.hpp"
+
+#include "./vkengine.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cassert>
+#include <cinttypes>
+
+#include <span>
+#include <vector>
+#include <algorithm>
+
+#include <ranges>
+
+namespace
+{
+    bool same_attachment(const blk::FramebufferCache::Attachment& lhs, const blk::FramebufferCache::Attachment& rhs, bool imageless)
+    {
+        return (imageless || (lhs.view == rhs.view))
+            && (lhs.format == rhs.format)
+            && (lhs.usage == rhs.usage)
+            && (lhs.extent.width == rhs.extent.width)
+            && (lhs.extent.height == rhs.extent.height);
+    }
+}
+
+namespace blk
+{
+
+FramebufferCache::FramebufferCache(blk::Engine& vkengine, std::uint64_t max_unused_frames)
+    : mEngine(vkengine)
+    , mImageless(vkengine.mImagelessFramebuffer)
+    , mMaxUnusedFrames(max_unused_frames)
+{
+}
+
+FramebufferCache::~FramebufferCache()
+{
+    // NOTE Device must be idle
+    for (auto&& entry : mEntries)
+        vkDestroyFramebuffer(mEngine.mDevice, entry.framebuffer, nullptr);
+}
+
+VkFramebuffer FramebufferCache::acquire(VkRenderPass renderpass, const VkExtent2D& extent, const std::span<const Attachment>& attachments)
+{
+    auto finder = std::ranges::find_if(
+        mEntries,
+        [&](const Entry& entry) {
+            return (entry.renderpass == renderpass)
+                && (entry.extent.width == extent.width)
+                && (entry.extent.height == extent.height)
+                && std::ranges::equal(
+                    entry.attachments, attachments,
+                    [this](const Attachment& lhs, const Attachment& rhs) {
+                        return same_attachment(lhs, rhs, mImageless);
+                    }
+                );
+        }
+    );
+    if (finder != std::ranges::end(mEntries))
+    {
+        finder->serial = mEngine.mRetireQueue.mSerial;
+        return finder->framebuffer;
+    }
+
+    std::vector<VkImageView> views;
+    std::vector<VkFramebufferAttachmentImageInfo> infos_attachment;
+    views.reserve(attachments.size());
+    infos_attachment.reserve(attachments.size());
+    for (auto&& attachment : attachments)
+    {
+        views.push_back(attachment.view);
+        infos_attachment.push_back(VkFramebufferAttachmentImageInfo{
+            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO,
+            .pNext           = nullptr,
+            .flags           = 0,
+            .usage           = attachment.usage,
+            .width           = attachment.extent.width,
+            .height          = attachment.extent.height,
+            .layerCount      = 1,
+            .viewFormatCount = 1,
+            .pViewFormats    = &(attachment.format),
+        });
+    }
+    const VkFramebufferAttachmentsCreateInfo info_attachments{
+        .sType                    = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO,
+        .pNext                    = nullptr,
+        .attachmentImageInfoCount = static_cast<std::uint32_t>(infos_attachment.size()),
+        .pAttachmentImageInfos    = infos_attachment.data(),
+    };
+    const VkFramebufferCreateInfo info{
+        .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+        .pNext           = mImageless ? &info_attachments : nullptr,
+        .flags           = mImageless ? VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT : 0u,
+        .renderPass      = renderpass,
+        .attachmentCount = static_cast<std::uint32_t>(attachments.size()),
+        .pAttachments    = mImageless ? nullptr : views.data(),
+        .width           = extent.width,
+        .height          = extent.height,
+        .layers          = 1,
+    };
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    CHECK(vkCreateFramebuffer(mEngine.mDevice, &info, nullptr, &framebuffer));
+    ++mCreations;
+
+    mEntries.push_back(Entry{
+        .renderpass  = renderpass,
+        .extent      = extent,
+        .attachments = std::vector<Attachment>(std::begin(attachments), std::end(attachments)),
+        .framebuffer = framebuffer,
+        .serial      = mEngine.mRetireQueue.mSerial,
+    });
+    return framebuffer;
+}
+
+void FramebufferCache::collect()
+{
+    const std::uint64_t serial = mEngine.mRetireQueue.mSerial;
+    auto unused = std::ranges::remove_if(
+        mEntries,
+        [this, serial](const Entry& entry) {
+            if (serial - entry.serial <= mMaxUnusedFrames)
+                return false;
+
+            // NOTE Not used by any in-flight frame, yet released along with other retired objects
+            mEngine.mRetireQueue.retire(
+                [device = static_cast<VkDevice>(mEngine.mDevice), framebuffer = entry.framebuffer]{
+                    vkDestroyFramebuffer(device, framebuffer, nullptr);
+                }
+            );
+            return true;
+        }
+    );
+    mEntries.erase(std::ranges::begin(unused), std::ranges::end(unused));
+}
+
+void FramebufferCache::forget(VkImageView view)
+{
+    if (mImageless)
+        return;
+
+    auto stale = std::ranges::remove_if(
+        mEntries,
+        [this, view](const Entry& entry) {
+            const bool referenced = std::ranges::any_of(entry.attachments, [view](const Attachment& attachment) {
+                return attachment.view == view;
+            });
+            if (!referenced)
+                return false;
+
+            // NOTE Latest frame may still use it
+            mEngine.mRetireQueue.retire(
+                [device = static_cast<VkDevice>(mEngine.mDevice), framebuffer = entry.framebuffer]{
+                    vkDestroyFramebuffer(device, framebuffer, nullptr);
+                }
+            );
+            return true;
+        }
+    );
+    mEntries.erase(std::ranges::begin(stale), std::ranges::end(stale));
+}
+
+}
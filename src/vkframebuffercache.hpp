@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cinttypes>
+
+#include <span>
+#include <vector>
+
+namespace blk
+{
+    struct Engine;
+
+    // Framebuffers created on demand, keyed by (render pass, extent, attachments)
+    //  - imageless (VK_KHR_imageless_framebuffer, core 1.2) : attachments are described by format, usage and image extent,
+    //    one framebuffer serves every swapchain image, views are provided when beginning the render pass
+    //  - otherwise : attachments views are part of the key
+    //  Entries unused for a few frames are retired
+    struct FramebufferCache
+    {
+        static constexpr std::uint64_t kMaxUnusedFrames = 8;
+
+        struct Attachment
+        {
+            VkImageView       view;
+            VkFormat          format;
+            VkImageUsageFlags usage;
+            // Extent of the image the view was created from
+            VkExtent2D        extent;
+        };
+
+        struct Entry
+        {
+            VkRenderPass            renderpass;
+            VkExtent2D              extent;
+            std::vector<Attachment> attachments;
+            VkFramebuffer           framebuffer;
+            // Serial of the latest frame using it, see RetireQueue
+            std::uint64_t           serial;
+        };
+
+        explicit FramebufferCache(blk::Engine& vkengine, std::uint64_t max_unused_frames = kMaxUnusedFrames);
+        ~FramebufferCache();
+
+        FramebufferCache(const FramebufferCache& rhs) = delete;
+        FramebufferCache& operator=(const FramebufferCache& rhs) = delete;
+
+        // Framebuffer compatible with renderpass, for the current frame
+        [[nodiscard]] VkFramebuffer acquire(VkRenderPass renderpass, const VkExtent2D& extent, const std::span<const Attachment>& attachments);
+
+        // Retire entries unused for too long, to call once per frame
+        void collect();
+
+        // Retire entries referencing this view, before it is destroyed
+        //  NOTE Handles may be recycled, a stale entry could otherwise match a new view
+        void forget(VkImageView view);
+
+        [[nodiscard]] constexpr bool imageless() const
+        {
+            return mImageless;
+        }
+
+        blk::Engine&       mEngine;
+        const bool         mImageless;
+        std::uint64_t      mMaxUnusedFrames;
+
+        std::vector<Entry> mEntries;
+        // Framebuffers created since startup, to monitor cache efficiency
+        std::uint32_t      mCreations = 0;
+    };
+}
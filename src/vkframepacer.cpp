@@ -0,0 +1,174 @@
+#include "./vkframepacer.hpp"
+
+#include "./vkdebug.hpp"
+
+#include "./vkengine.hpp"
+#include "./vkpresentation.hpp"
+#include "./vkprofiler.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cmath>
+#include <cinttypes>
+
+#include <limits>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+
+namespace
+{
+    // NOTE Bounded, a present may never be displayed (e.g. minimized window, MAILBOX replacing it)
+    constexpr std::uint64_t kTimeoutPresentWait = 100'000'000; // 100ms
+}
+
+namespace blk
+{
+
+FramePacer::FramePacer(blk::Engine& vkengine, const blk::Presentation& vkpresentation)
+    : mEngine(vkengine)
+    , mPresentation(vkpresentation)
+    , mPresentWait(vkengine.mPresentWait)
+{
+    const VkFenceCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = VK_FENCE_CREATE_SIGNALED_BIT,
+    };
+    CHECK(vkCreateFence(mEngine.mDevice, &info, nullptr, &mFence));
+}
+
+FramePacer::~FramePacer()
+{
+    vkDestroyFence(mEngine.mDevice, mFence, nullptr);
+}
+
+void FramePacer::wait_previous_frame() const
+{
+    CHECK(vkWaitForFences(mEngine.mDevice, 1, &mFence, VK_TRUE, std::numeric_limits<std::uint64_t>::max()));
+}
+
+void FramePacer::begin_frame()
+{
+    BLK_PROFILE_ZONE("FramePacer::begin_frame");
+    {// Previous frame submission
+        wait_previous_frame();
+        mCompletionTick = clock_t::now();
+        CHECK(vkResetFences(mEngine.mDevice, 1, &mFence));
+        // NOTE Single frame in flight, every previous frame is complete
+        mEngine.mRetireQueue.begin_frame(mEngine.mRetireQueue.mSerial);
+    }
+
+    #if defined(VK_KHR_PRESENT_WAIT_EXTENSION_NAME) && defined(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+    if (mPresentWait && (mPresentId >= mSwapchainFirstId + mMaxQueuedPresents))
+    {// Previous presents display
+        const std::uint64_t id = mPresentId - mMaxQueuedPresents;
+        const VkResult result = mEngine.mWaitForPresent(
+            mEngine.mDevice,
+            mPresentation.mSwapchain,
+            id,
+            kTimeoutPresentWait
+        );
+        if (result == VK_SUCCESS)
+        {
+            const tick_t tick = clock_t::now();
+            // NOTE Only consecutive presents, an interval spanning a timed out wait is not one present long
+            if ((mDisplayedId != 0) && (id == mDisplayedId + 1))
+                push_interval(tick - mDisplayTick);
+            mDisplayedId = id;
+            mDisplayTick = tick;
+        }
+        // NOTE Swapchain issues are handled when presenting
+        else if ((result != VK_TIMEOUT) && (result != VK_SUBOPTIMAL_KHR) && (result != VK_ERROR_OUT_OF_DATE_KHR))
+            CHECK(result);
+    }
+    #endif
+
+    if (mHasFrameTick && (mTargetInterval.count() > 0.0f))
+    {
+        std::this_thread::sleep_until(mFrameTick + std::chrono::duration_cast<clock_t::duration>(mTargetInterval));
+    }
+
+    mFrameTick    = clock_t::now();
+    mHasFrameTick = true;
+}
+
+VkFence FramePacer::fence() const
+{
+    return mFence;
+}
+
+std::uint64_t FramePacer::present_id() const
+{
+    return mPresentWait ? (mPresentId + 1) : 0;
+}
+
+void FramePacer::end_frame()
+{
+    if (mPresentWait)
+    {
+        ++mPresentId;
+        return;
+    }
+
+    const tick_t tick = clock_t::now();
+    if (mHasPresentTick)
+        push_interval(tick - mPresentTick);
+    mPresentTick    = tick;
+    mHasPresentTick = true;
+}
+
+void FramePacer::onSwapchainRecreated()
+{
+    mSwapchainFirstId = mPresentId + 1;
+    mDisplayedId      = 0;
+    // NOTE Recreation stalls the frame, do not account for it
+    mHasPresentTick = false;
+    mHasFrameTick   = false;
+}
+
+void FramePacer::set_target_interval(const duration_t& interval)
+{
+    mTargetInterval = interval;
+}
+
+void FramePacer::set_max_queued_presents(std::uint64_t count)
+{
+    mMaxQueuedPresents = count;
+}
+
+void FramePacer::push_interval(const duration_t& interval)
+{
+    mIntervals[mIntervalCursor] = interval.count();
+    mIntervalCursor = (mIntervalCursor + 1) % kIntervalCount;
+    mIntervalSize   = std::min(mIntervalSize + 1, kIntervalCount);
+}
+
+FramePacer::Statistics FramePacer::statistics() const
+{
+    if (mIntervalSize == 0)
+        return Statistics{};
+
+    const auto first = std::begin(mIntervals);
+    const auto last  = std::next(first, mIntervalSize);
+
+    float sum = 0.0f;
+    for (auto it = first; it != last; ++it)
+        sum += *it;
+    const float mean = sum / mIntervalSize;
+
+    float variance = 0.0f;
+    for (auto it = first; it != last; ++it)
+        variance += (*it - mean) * (*it - mean);
+    variance /= mIntervalSize;
+
+    const auto [min, max] = std::minmax_element(first, last);
+    return Statistics{
+        .mean   = mean,
+        .jitter = std::sqrt(variance),
+        .min    = *min,
+        .max    = *max,
+    };
+}
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cinttypes>
+
+#include <array>
+#include <chrono>
+
+namespace blk
+{
+    struct Engine;
+    struct Presentation;
+
+    // Bound the amount of work queued ahead of the display, and measure present intervals
+    //  - VK_KHR_present_wait : wait for the previous present to be displayed before starting a new frame
+    //  - otherwise           : wait for the previous frame submission fence
+    //  In both cases, the previous frame submission has completed once begin_frame returns
+    struct FramePacer
+    {
+        using clock_t    = std::chrono::steady_clock;
+        using tick_t     = clock_t::time_point;
+        using duration_t = std::chrono::duration<float, std::milli>;
+
+        static constexpr std::size_t   kIntervalCount     = 120;
+        // Presents allowed to be pending display when a new frame starts, by default
+        static constexpr std::uint64_t kMaxQueuedPresents = 1;
+
+        struct Statistics
+        {
+            // In milliseconds, over the last kIntervalCount present to present intervals
+            //  - VK_KHR_present_wait : between consecutive presents displayed
+            //  - otherwise           : between consecutive vkQueuePresentKHR returns
+            float mean   = 0.0f;
+            float jitter = 0.0f; // standard deviation
+            float min    = 0.0f;
+            float max    = 0.0f;
+        };
+
+        explicit FramePacer(blk::Engine& vkengine, const blk::Presentation& vkpresentation);
+        ~FramePacer();
+
+        FramePacer(const FramePacer& rhs) = delete;
+        FramePacer& operator=(const FramePacer& rhs) = delete;
+
+        // Block until the previous frame submission is complete, e.g. before touching single-buffered resources
+        void wait_previous_frame() const;
+        // Block until the previous frame is done, then until the target interval elapsed since the previous frame
+        //  Objects retired up to the previous frame are released
+        void begin_frame();
+        // Fence to be signaled by the frame submission, reset by begin_frame
+        [[nodiscard]] VkFence fence() const;
+        // Identifier to tag the frame present with, 0 when present wait is unavailable
+        [[nodiscard]] std::uint64_t present_id() const;
+        // To call right after the frame has been presented with present_id
+        void end_frame();
+
+        // Present ids of a previous swapchain cannot be waited on anymore
+        void onSwapchainRecreated();
+
+        // Zero means unbounded, i.e. only limited by the present mode
+        void set_target_interval(const duration_t& interval);
+        // Zero means a new frame only starts once the previous one is displayed, see LatencyController
+        void set_max_queued_presents(std::uint64_t count);
+
+        [[nodiscard]] Statistics statistics() const;
+
+        [[nodiscard]] constexpr bool uses_present_wait() const
+        {
+            return mPresentWait;
+        }
+
+        void push_interval(const duration_t& interval);
+
+        blk::Engine&                        mEngine;
+        const blk::Presentation&            mPresentation;
+        const bool                          mPresentWait;
+
+        // NOTE Created signaled, there is no previous frame to wait for initially
+        VkFence                             mFence            = VK_NULL_HANDLE;
+
+        // Last presented id
+        std::uint64_t                       mPresentId        = 0;
+        // First id presented with the current swapchain
+        std::uint64_t                       mSwapchainFirstId = 1;
+        std::uint64_t                       mMaxQueuedPresents = kMaxQueuedPresents;
+        // Last present known to be displayed, i.e. whose wait succeeded, 0 if none
+        //  NOTE Display tick is when the wait returned, only accurate when it blocked
+        std::uint64_t                       mDisplayedId      = 0;
+        tick_t                              mDisplayTick;
+
+        // When the previous present request returned, without present wait
+        tick_t                              mPresentTick;
+        bool                                mHasPresentTick   = false;
+
+        duration_t                          mTargetInterval   = duration_t(0.0f);
+        // Frame start, the target interval is counted from
+        tick_t                              mFrameTick;
+        bool                                mHasFrameTick     = false;
+        // When the previous frame submission was known to be complete
+        tick_t                              mCompletionTick;
+
+        // Present to present, in milliseconds, see Statistics
+        std::array<float, kIntervalCount>   mIntervals        = {};
+        std::size_t                         mIntervalCursor   = 0;
+        std::size_t                         mIntervalSize     = 0;
+    };
+}
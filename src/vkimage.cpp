@@ -1,6 +1,7 @@
 #include "./vkimage.hpp"
 
 #include "./vkmemory.hpp"
+#include "./vkmemorytracer.hpp"
 
 namespace blk
 {
@@ -8,6 +9,8 @@ namespace blk
     {
         if (mImage != VK_NULL_HANDLE)
         {
+            const VkDeviceSize offset = mOffset;
+
             vkDestroyImage(mDevice, mImage, nullptr);
             mImage   = VK_NULL_HANDLE;
             mOffset   = ~0;
@@ -18,6 +21,8 @@ namespace blk
                 // FIXME We Assume that this is always the last resource which is unbind from memory
                 mMemory->mNextOffset -= mRequirements.size;
                 mMemory->mFree       += mRequirements.size;
+
+                MemoryTracer::instance().release(mMemory->mMemory, offset, mMemory->mNextOffset);
             }
             mMemory   = nullptr;
         }
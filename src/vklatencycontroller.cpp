@@ -0,0 +1,145 @@
+#include "./vklatencycontroller.hpp"
+
+#include "./vkprofiler.hpp"
+
+#include <cmath>
+#include <cinttypes>
+
+#include <thread>
+#include <utility>
+#include <algorithm>
+
+namespace
+{
+    float milliseconds(const blk::LatencyController::clock_t::duration& duration)
+    {
+        return std::max(0.0f, blk::LatencyController::duration_t(duration).count());
+    }
+}
+
+namespace blk
+{
+
+void LatencyController::History::push(float value)
+{
+    mValues[mCursor] = value;
+    mCursor = (mCursor + 1) % kHistoryCount;
+    mSize   = std::min(mSize + 1, kHistoryCount);
+}
+
+float LatencyController::History::mean() const
+{
+    if (mSize == 0)
+        return 0.0f;
+
+    float sum = 0.0f;
+    for (std::size_t idx = 0; idx < mSize; ++idx)
+        sum += mValues[idx];
+    return sum / mSize;
+}
+
+float LatencyController::History::predict() const
+{
+    if (mSize == 0)
+        return 0.0f;
+
+    const float average = mean();
+    float variance = 0.0f;
+    for (std::size_t idx = 0; idx < mSize; ++idx)
+        variance += (mValues[idx] - average) * (mValues[idx] - average);
+    variance /= mSize;
+
+    return average + 2.0f * std::sqrt(variance);
+}
+
+void LatencyController::wait_frame_start(const blk::FramePacer& pacer)
+{
+    BLK_PROFILE_ZONE("LatencyController::wait_frame_start");
+    if (mSubmitted)
+    {// NOTE Upper bound, completion is only observed when the pacer waits for it
+        mGPU.push(milliseconds(pacer.mCompletionTick - mSubmitTick));
+        mSubmitted = false;
+    }
+
+    if ((pacer.mDisplayedId != 0) && (pacer.mDisplayedId != mDisplayedId))
+    {// New display
+        if ((mDisplayedId != 0) && (pacer.mDisplayedId == mDisplayedId + 1))
+            mRefresh.push(milliseconds(pacer.mDisplayTick - mDisplayTick));
+
+        // NOTE Displayed frame may not be the last presented one, e.g. when a present is queued
+        const Present& present = mPresents[pacer.mDisplayedId % kPresentCount];
+        if (present.id == pacer.mDisplayedId)
+        {
+            // NOTE Estimates pushed until the first display are discarded
+            if (!std::exchange(mMeasured, true))
+                mLatency = History{};
+            mLatency.push(milliseconds(pacer.mDisplayTick - present.input_tick));
+        }
+
+        mDisplayedId = pacer.mDisplayedId;
+        mDisplayTick = pacer.mDisplayTick;
+    }
+
+    const tick_t now = clock_t::now();
+    float sleep = 0.0f;
+    // NOTE Deadline is only known when the last presented frame was just displayed, i.e. nothing is queued
+    if (mEnabled && (mDisplayedId != 0) && (mDisplayedId == mPresentedId) && (mRefresh.mSize > 0))
+    {
+        const float interval = std::max(pacer.mTargetInterval.count(), mRefresh.mean());
+        const float work     = mCPU.predict() + mGPU.predict() + kSafetyMargin;
+        if (work < interval)
+        {
+            const tick_t start = mDisplayTick + std::chrono::duration_cast<clock_t::duration>(duration_t(interval - work));
+            if (start > now)
+            {
+                std::this_thread::sleep_until(start);
+                sleep = milliseconds(start - now);
+            }
+        }
+    }
+    mSleep.push(sleep);
+
+    mInputTick = clock_t::now();
+}
+
+void LatencyController::submitted()
+{
+    mSubmitTick = clock_t::now();
+    mSubmitted  = true;
+    mCPU.push(milliseconds(mSubmitTick - mInputTick));
+}
+
+void LatencyController::presented(const blk::FramePacer& pacer, std::uint64_t present_id)
+{
+    mPresentedId = present_id;
+    if (present_id != 0)
+        mPresents[present_id % kPresentCount] = Present{ .id = present_id, .input_tick = mInputTick };
+
+    if ((present_id == 0) || !mMeasured)
+    {// Estimated : input to present, then about one frame interval until displayed
+        mLatency.push(milliseconds(clock_t::now() - mInputTick) + pacer.statistics().mean);
+        mMeasured = false;
+    }
+}
+
+void LatencyController::onSwapchainRecreated()
+{
+    // NOTE Recreation stalls the frame, do not account for it
+    mSubmitted   = false;
+    mPresentedId = 0;
+    mDisplayedId = 0;
+    mPresents    = {};
+}
+
+LatencyController::Statistics LatencyController::statistics() const
+{
+    return Statistics{
+        .cpu      = mCPU.predict(),
+        .gpu      = mGPU.predict(),
+        .sleep    = mSleep.mean(),
+        .latency  = mLatency.mean(),
+        .measured = mMeasured,
+    };
+}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cinttypes>
+
+#include <array>
+#include <chrono>
+
+#include "./vkframepacer.hpp"
+
+namespace blk
+{
+    // Delay the frame start (i.e. input sampling) to the latest moment its work can still make the next display
+    //  CPU (input sampling to submission) and GPU (submission to completion) durations are predicted from recent frames
+    //  NOTE Requires VK_KHR_present_wait to know display deadlines, otherwise only latency is reported
+    struct LatencyController
+    {
+        using clock_t    = blk::FramePacer::clock_t;
+        using tick_t     = blk::FramePacer::tick_t;
+        using duration_t = blk::FramePacer::duration_t;
+
+        static constexpr std::size_t kHistoryCount = 60;
+        // Presents whose input tick is kept until displayed, more than can be queued
+        static constexpr std::size_t kPresentCount = 8;
+        static_assert(kPresentCount > blk::FramePacer::kMaxQueuedPresents);
+        // Prediction errors absorbed before missing a display
+        static constexpr float       kSafetyMargin = 1.0f; // ms
+
+        // Recent durations, in milliseconds
+        struct History
+        {
+            void  push(float value);
+            // Conservative estimate : mean + 2 standard deviations
+            float predict() const;
+            float mean() const;
+
+            std::array<float, kHistoryCount> mValues = {};
+            std::size_t                      mCursor = 0;
+            std::size_t                      mSize   = 0;
+        };
+
+        struct Statistics
+        {
+            // In milliseconds
+            float cpu     = 0.0f;
+            float gpu     = 0.0f;
+            float sleep   = 0.0f;
+            float latency = 0.0f;
+            // Latency measured from display, otherwise estimated from present
+            bool  measured = false;
+        };
+
+        // Sleep until the latest safe frame start, input is considered sampled when returning
+        //  NOTE To call after FramePacer::begin_frame
+        void wait_frame_start(const blk::FramePacer& pacer);
+        // Frame work was submitted
+        void submitted();
+        // Frame was presented with present_id (0 when untagged)
+        void presented(const blk::FramePacer& pacer, std::uint64_t present_id);
+
+        void onSwapchainRecreated();
+
+        [[nodiscard]] Statistics statistics() const;
+
+        // When disabled, frames start as soon as the pacer allows it, statistics are still gathered
+        bool          mEnabled          = false;
+
+        History       mCPU;
+        History       mGPU;
+        History       mSleep;
+        History       mLatency;
+        // Interval between consecutive displays
+        History       mRefresh;
+        bool          mMeasured         = false;
+
+        tick_t        mInputTick;
+        tick_t        mSubmitTick;
+        bool          mSubmitted        = false;
+
+        struct Present
+        {
+            std::uint64_t id = 0;
+            tick_t        input_tick;
+        };
+
+        // Last presented frame
+        std::uint64_t mPresentedId      = 0;
+        // Recent tagged presents, indexed by id modulo kPresentCount
+        std::array<Present, kPresentCount> mPresents;
+        // Last display accounted for
+        std::uint64_t mDisplayedId      = 0;
+        tick_t        mDisplayTick;
+    };
+}
@@ -46,6 +46,8 @@ namespace
                 memory.mNextOffset += buffer->mRequirements.size;
                 memory.mFree       -= buffer->mRequirements.size;
 
+                blk::MemoryTracer::instance().bind(memory.mMemory, buffer->mName, buffer->mOffset, buffer->mRequirements.size, memory.mNextOffset, false);
+
                 return info;
             }
         );
@@ -90,6 +92,8 @@ namespace
                 memory.mNextOffset += image->mRequirements.size;
                 memory.mFree       -= image->mRequirements.size;
 
+                blk::MemoryTracer::instance().bind(memory.mMemory, image->mName, image->mOffset, image->mRequirements.size, memory.mNextOffset, true);
+
                 return info;
             }
         );
@@ -174,6 +178,8 @@ namespace blk
 
         mNextOffset += buffer.mRequirements.size;
         mFree       -= buffer.mRequirements.size;
+
+        MemoryTracer::instance().bind(mMemory, buffer.mName, buffer.mOffset, buffer.mRequirements.size, mNextOffset, false);
         
         auto result = vkBindBufferMemory2(mDevice, 1, &info);
         CHECK(result);
@@ -210,6 +216,8 @@ namespace blk
 
         mNextOffset += image.mRequirements.size;
         mFree       -= image.mRequirements.size;
+
+        MemoryTracer::instance().bind(mMemory, image.mName, image.mOffset, image.mRequirements.size, mNextOffset, true);
         
         auto result = vkBindImageMemory2(mDevice, 1, &info);
         CHECK(result);
@@ -11,6 +11,8 @@
 #include <vector>
 
 #include "./vkdebug.hpp"
+#include "./vkdebugutils.hpp"
+#include "./vkmemorytracer.hpp"
 
 namespace blk
 {
@@ -106,17 +108,20 @@ namespace blk
             return *this;
         }
 
-        VkResult allocate(VkDevice vkdevice)
+        // name is recorded for debuggers (see blk::debug::name) and blk::MemoryTracer, i.e. a string literal
+        VkResult allocate(VkDevice vkdevice, const char* name = nullptr)
         {
             mDevice = vkdevice;
             auto result = vkAllocateMemory(mDevice, &mInfo, nullptr, &mMemory);
             CHECK(result);
+            debug::name(mDevice, mMemory, name);
+            MemoryTracer::instance().allocate(mMemory, name, mType.mIndex, mType.mType.heapIndex, mInfo.allocationSize);
             mNextOffset = 0;
             mFree = mInfo.allocationSize;
             return result;
         }
 
-        VkResult reallocate(VkDevice vkdevice, VkDeviceSize size)
+        VkResult reallocate(VkDevice vkdevice, VkDeviceSize size, const char* name = nullptr)
         {
             assert((mDevice == VK_NULL_HANDLE) || (mDevice == vkdevice));
             
@@ -130,6 +135,8 @@ namespace blk
 
             auto result = vkAllocateMemory(mDevice, &mInfo, nullptr, &mMemory);
             CHECK(result);
+            debug::name(mDevice, mMemory, name);
+            MemoryTracer::instance().allocate(mMemory, name, mType.mIndex, mType.mType.heapIndex, mInfo.allocationSize);
             mNextOffset = 0;
             mFree = mInfo.allocationSize;
             return result;
@@ -139,6 +146,7 @@ namespace blk
         {
             if (mMemory != VK_NULL_HANDLE)
             {
+                MemoryTracer::instance().deallocate(mMemory);
                 vkFreeMemory(mDevice, mMemory, nullptr);
                 mMemory = VK_NULL_HANDLE;
             }
@@ -0,0 +1,190 @@
+#include "./vkmemorytracer.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <mutex>
+#include <vector>
+#include <ostream>
+#include <iterator>
+#include <algorithm>
+
+namespace
+{
+    constexpr const char* kOperationNames[] = {
+        "allocate",
+        "free",
+        "bind",
+        "release",
+    };
+
+    bool same_suballocations(const blk::MemoryTracer::Block& lhs, const blk::MemoryTracer::Block& rhs)
+    {
+        return std::ranges::equal(lhs.suballocations, rhs.suballocations, [](const auto& l, const auto& r) {
+            return (l.owner == r.owner) && (l.offset == r.offset) && (l.size == r.size);
+        });
+    }
+}
+
+namespace blk
+{
+
+VkDeviceSize MemoryTracer::Block::used() const
+{
+    VkDeviceSize bytes = 0;
+    for (auto&& suballocation : suballocations)
+        bytes += suballocation.size;
+    return bytes;
+}
+
+VkDeviceSize MemoryTracer::Block::holes() const
+{
+    const VkDeviceSize bound = used();
+    return (next_offset > bound) ? (next_offset - bound) : 0;
+}
+
+float MemoryTracer::Block::fragmentation() const
+{
+    const VkDeviceSize lost = holes();
+    const VkDeviceSize tail = (size > next_offset) ? (size - next_offset) : 0;
+    return (lost + tail > 0) ? static_cast<float>(lost) / static_cast<float>(lost + tail) : 0.0f;
+}
+
+MemoryTracer& MemoryTracer::instance()
+{
+    static MemoryTracer sTracer;
+    return sTracer;
+}
+
+void MemoryTracer::allocate(VkDeviceMemory memory, const char* name, std::uint32_t type, std::uint32_t heap, VkDeviceSize size)
+{
+    std::lock_guard lock(mMutex);
+    const Block& block = mBlocks.emplace_back(Block{
+        .id             = mNextId++,
+        .memory         = memory,
+        .name           = name,
+        .type           = type,
+        .heap           = heap,
+        .size           = size,
+        .next_offset    = 0,
+        .frame          = mFrame,
+        .suballocations = {},
+    });
+
+    mLog.push_back(Event{ .frame = mFrame, .operation = Operation::Allocate, .block = block.id, .name = name, .type = type, .heap = heap, .offset = 0, .size = size });
+    while (mLog.size() > kLogCapacity)
+        mLog.pop_front();
+}
+
+void MemoryTracer::deallocate(VkDeviceMemory memory)
+{
+    std::lock_guard lock(mMutex);
+    auto block = std::ranges::find(mBlocks, memory, &Block::memory);
+    if (block == std::end(mBlocks))
+        return;
+
+    mLog.push_back(Event{ .frame = mFrame, .operation = Operation::Free, .block = block->id, .name = block->name, .type = block->type, .heap = block->heap, .offset = 0, .size = block->size });
+    while (mLog.size() > kLogCapacity)
+        mLog.pop_front();
+
+    mBlocks.erase(block);
+}
+
+void MemoryTracer::bind(VkDeviceMemory memory, const char* owner, VkDeviceSize offset, VkDeviceSize size, VkDeviceSize next_offset, bool image)
+{
+    std::lock_guard lock(mMutex);
+    auto block = std::ranges::find(mBlocks, memory, &Block::memory);
+    if (block == std::end(mBlocks))
+        return;
+
+    block->suballocations.push_back(SubAllocation{ .owner = owner, .offset = offset, .size = size, .image = image });
+    block->next_offset = next_offset;
+
+    mLog.push_back(Event{ .frame = mFrame, .operation = Operation::Bind, .block = block->id, .name = owner, .type = block->type, .heap = block->heap, .offset = offset, .size = size });
+    while (mLog.size() > kLogCapacity)
+        mLog.pop_front();
+}
+
+void MemoryTracer::release(VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize next_offset)
+{
+    std::lock_guard lock(mMutex);
+    auto block = std::ranges::find(mBlocks, memory, &Block::memory);
+    if (block == std::end(mBlocks))
+        return;
+
+    auto suballocation = std::ranges::find(block->suballocations, offset, &SubAllocation::offset);
+    if (suballocation == std::end(block->suballocations))
+        return;
+
+    mLog.push_back(Event{ .frame = mFrame, .operation = Operation::Release, .block = block->id, .name = suballocation->owner, .type = block->type, .heap = block->heap, .offset = offset, .size = suballocation->size });
+    while (mLog.size() > kLogCapacity)
+        mLog.pop_front();
+
+    block->suballocations.erase(suballocation);
+    block->next_offset = next_offset;
+}
+
+void MemoryTracer::begin_frame()
+{
+    std::lock_guard lock(mMutex);
+    ++mFrame;
+}
+
+MemoryTracer::Snapshot MemoryTracer::snapshot() const
+{
+    std::lock_guard lock(mMutex);
+    return Snapshot{ .frame = mFrame, .blocks = mBlocks };
+}
+
+MemoryTracer::Difference MemoryTracer::difference(const Snapshot& before, const Snapshot& after)
+{
+    // NOTE Blocks are in order of allocation, i.e. sorted by id
+    Difference difference;
+    auto lhs = std::begin(before.blocks);
+    auto rhs = std::begin(after.blocks);
+    while ((lhs != std::end(before.blocks)) || (rhs != std::end(after.blocks)))
+    {
+        if ((rhs == std::end(after.blocks)) || ((lhs != std::end(before.blocks)) && (lhs->id < rhs->id)))
+        {
+            difference.freed.push_back(*lhs);
+            difference.bytes -= static_cast<std::int64_t>(lhs->size);
+            ++lhs;
+        }
+        else if ((lhs == std::end(before.blocks)) || (rhs->id < lhs->id))
+        {
+            difference.allocated.push_back(*rhs);
+            difference.bytes += static_cast<std::int64_t>(rhs->size);
+            ++rhs;
+        }
+        else
+        {
+            if (!same_suballocations(*lhs, *rhs))
+                difference.changed.push_back(*rhs);
+            ++lhs;
+            ++rhs;
+        }
+    }
+    return difference;
+}
+
+void MemoryTracer::export_log(std::ostream& stream) const
+{
+    std::lock_guard lock(mMutex);
+    stream << "frame,operation,block,name,type,heap,offset,size\n";
+    for (auto&& event : mLog)
+    {
+        stream << event.frame << ','
+               << kOperationNames[static_cast<std::size_t>(event.operation)] << ','
+               << event.block << ','
+               << ((event.name != nullptr) ? event.name : "") << ','
+               << event.type << ','
+               << event.heap << ','
+               << event.offset << ','
+               << event.size << '\n';
+    }
+    stream << std::flush;
+}
+
+}
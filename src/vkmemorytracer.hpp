@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <ostream>
+
+namespace blk
+{
+    // Device memory allocations (blk::Memory) and the resources bound into them, see Memory::allocate and Memory::bind
+    //  NOTE Names must outlive the tracer, i.e. string literals, see Buffer::create and Image::create
+    struct MemoryTracer
+    {
+        static constexpr std::size_t kLogCapacity = 1 << 12;
+
+        struct SubAllocation
+        {
+            const char*  owner;
+            VkDeviceSize offset;
+            VkDeviceSize size;
+            bool         image;
+        };
+
+        struct Block
+        {
+            // Unique per allocation, unlike VkDeviceMemory handles which drivers may recycle
+            std::uint64_t              id;
+            VkDeviceMemory             memory;
+            const char*                name;
+            std::uint32_t              type;
+            std::uint32_t              heap;
+            VkDeviceSize               size;
+            // Linear allocation cursor, see Memory::mNextOffset
+            VkDeviceSize               next_offset;
+            // Frame of the allocation, see begin_frame
+            std::uint64_t              frame;
+            std::vector<SubAllocation> suballocations;
+
+            // Bytes of bound resources still alive
+            [[nodiscard]] VkDeviceSize used() const;
+            // Bytes below the cursor not bound to any resource, lost until the block is freed
+            [[nodiscard]] VkDeviceSize holes() const;
+            // Ratio of free bytes lost in holes, the rest can still be bound past the cursor
+            [[nodiscard]] float fragmentation() const;
+        };
+
+        enum class Operation : std::uint8_t
+        {
+            Allocate,
+            Free,
+            Bind,
+            Release,
+        };
+
+        struct Event
+        {
+            std::uint64_t frame;
+            Operation     operation;
+            std::uint64_t block;
+            // Block name when allocating or freeing, resource name otherwise
+            const char*   name;
+            std::uint32_t type;
+            std::uint32_t heap;
+            VkDeviceSize  offset;
+            VkDeviceSize  size;
+        };
+
+        struct Snapshot
+        {
+            std::uint64_t      frame = 0;
+            std::vector<Block> blocks;
+        };
+
+        struct Difference
+        {
+            std::vector<Block> allocated;
+            std::vector<Block> freed;
+            // Blocks alive in both snapshots whose bound resources changed, as of the later snapshot
+            std::vector<Block> changed;
+            // Allocated minus freed bytes
+            std::int64_t       bytes = 0;
+        };
+
+        static MemoryTracer& instance();
+
+        void allocate(VkDeviceMemory memory, const char* name, std::uint32_t type, std::uint32_t heap, VkDeviceSize size);
+        void deallocate(VkDeviceMemory memory);
+        void bind(VkDeviceMemory memory, const char* owner, VkDeviceSize offset, VkDeviceSize size, VkDeviceSize next_offset, bool image);
+        void release(VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize next_offset);
+
+        void begin_frame();
+
+        // Blocks alive, in order of allocation
+        [[nodiscard]] Snapshot snapshot() const;
+        [[nodiscard]] static Difference difference(const Snapshot& before, const Snapshot& after);
+
+        // Latest events as CSV, oldest first
+        void export_log(std::ostream& stream) const;
+
+        mutable std::mutex mMutex;
+        std::vector<Block> mBlocks;
+        std::deque<Event>  mLog;
+        std::uint64_t      mNextId = 0;
+        std::uint64_t      mFrame  = 0;
+    };
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "./vkqueries.hpp"
+#include "./vkdebugutils.hpp"
+
 #include <vulkan/vulkan_core.h>
 
 #include <cinttypes>
@@ -31,6 +34,21 @@ namespace blk
         virtual void record_pass(VkCommandBuffer commandbuffer) = 0;
     };
 
+    // Record a subpass within a debug label named after the pass, gathered into the statistics query of the subpass index when provided
+    template<typename PassType>
+    void record_subpass(PassType& pass, VkCommandBuffer commandbuffer, blk::PipelineStatisticsQueries* statistics)
+    {
+        const debug::ScopedLabel label(commandbuffer, PassType::kName);
+
+        if (statistics != nullptr)
+            statistics->begin(commandbuffer, pass.mSubpass);
+
+        pass.record_pass(commandbuffer);
+
+        if (statistics != nullptr)
+            statistics->end(commandbuffer, pass.mSubpass);
+    }
+
     template<typename PassType, typename ArgumentType>
     struct PassTrait
     {
@@ -62,14 +80,23 @@ namespace blk
         {
         }
 
-        void record(VkFramebuffer framebuffer, VkCommandBuffer commandbuffer, const VkRect2D& area, const std::span<const VkClearValue>& clear_values)
+        // NOTE renderpass overrides the passes render pass, it must be compatible with it
+        // NOTE attachments are only provided for imageless framebuffers
+        // NOTE statistics, when provided, gathers each subpass into the query of its index
+        void record(VkFramebuffer framebuffer, VkCommandBuffer commandbuffer, const VkRect2D& area, const std::span<const VkClearValue>& clear_values, VkRenderPass renderpass = VK_NULL_HANDLE, const std::span<const VkImageView>& attachments = {}, blk::PipelineStatisticsQueries* statistics = nullptr)
         {
             if constexpr (Index == 0)
             {
+                const VkRenderPassAttachmentBeginInfo info_attachments{
+                    .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO,
+                    .pNext           = nullptr,
+                    .attachmentCount = (std::uint32_t)attachments.size(),
+                    .pAttachments    = attachments.data(),
+                };
                 const VkRenderPassBeginInfo info{
                     .sType            = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-                    .pNext            = nullptr,
-                    .renderPass       = mPass.mRenderPass,
+                    .pNext            = attachments.empty() ? nullptr : &info_attachments,
+                    .renderPass       = (renderpass != VK_NULL_HANDLE) ? renderpass : static_cast<VkRenderPass>(mPass.mRenderPass),
                     .framebuffer      = framebuffer,
                     .renderArea       = area,
                     .clearValueCount  = (std::uint32_t)clear_values.size(),
@@ -82,8 +109,8 @@ namespace blk
                 vkCmdNextSubpass(commandbuffer, VK_SUBPASS_CONTENTS_INLINE);
             }
 
-            mPass.record_pass(commandbuffer);
-            
+            record_subpass(mPass, commandbuffer, statistics);
+
             if constexpr (Index == 0)
             {
                 vkCmdEndRenderPass(commandbuffer);
@@ -119,14 +146,23 @@ namespace blk
             return *this;
         }
 
-        void record(VkFramebuffer framebuffer, VkCommandBuffer commandbuffer, const VkRect2D& area, const std::span<const VkClearValue>& clear_values)
+        // NOTE renderpass overrides the passes render pass, it must be compatible with it
+        // NOTE attachments are only provided for imageless framebuffers
+        // NOTE statistics, when provided, gathers each subpass into the query of its index
+        void record(VkFramebuffer framebuffer, VkCommandBuffer commandbuffer, const VkRect2D& area, const std::span<const VkClearValue>& clear_values, VkRenderPass renderpass = VK_NULL_HANDLE, const std::span<const VkImageView>& attachments = {}, blk::PipelineStatisticsQueries* statistics = nullptr)
         {
             if constexpr (Index == 0)
             {
+                const VkRenderPassAttachmentBeginInfo info_attachments{
+                    .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO,
+                    .pNext           = nullptr,
+                    .attachmentCount = (std::uint32_t)attachments.size(),
+                    .pAttachments    = attachments.data(),
+                };
                 const VkRenderPassBeginInfo info{
                     .sType            = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-                    .pNext            = nullptr,
-                    .renderPass       = mPass.mRenderPass,
+                    .pNext            = attachments.empty() ? nullptr : &info_attachments,
+                    .renderPass       = (renderpass != VK_NULL_HANDLE) ? renderpass : static_cast<VkRenderPass>(mPass.mRenderPass),
                     .framebuffer      = framebuffer,
                     .renderArea       = area,
                     .clearValueCount  = (std::uint32_t)clear_values.size(),
@@ -139,9 +175,9 @@ namespace blk
                 vkCmdNextSubpass(commandbuffer, VK_SUBPASS_CONTENTS_INLINE);
             }
 
-            mPass.record_pass(commandbuffer);
+            record_subpass(mPass, commandbuffer, statistics);
 
-            tail().record(framebuffer, commandbuffer, area, clear_values);
+            tail().record(framebuffer, commandbuffer, area, clear_values, renderpass, attachments, statistics);
 
             if constexpr (Index == 0)
             {
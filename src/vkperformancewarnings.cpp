@@ -0,0 +1,125 @@
+#include "./vkperformancewarnings.hpp"
+
+#include "./vkdebug.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <sstream>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    std::string describe(const VkDebugUtilsObjectNameInfoEXT& object)
+    {
+        if ((object.pObjectName != nullptr) && (object.pObjectName[0] != '\0'))
+            return object.pObjectName;
+
+        std::ostringstream stream;
+        stream << "Type " << object.objectType << " 0x" << std::hex << object.objectHandle;
+        return stream.str();
+    }
+}
+
+namespace blk
+{
+
+PerformanceWarnings& PerformanceWarnings::instance()
+{
+    static PerformanceWarnings sWarnings;
+    return sWarnings;
+}
+
+VKAPI_ATTR VkBool32 VKAPI_CALL PerformanceWarnings::callback(
+    VkDebugUtilsMessageSeverityFlagBitsEXT      messageSeverity,
+    VkDebugUtilsMessageTypeFlagsEXT             messageType,
+    const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
+    void*                                       pUserData)
+{
+    (void)messageType;
+    static_cast<PerformanceWarnings*>(pUserData)->record(messageSeverity, *pCallbackData);
+    // NOTE See OutputStreamDebugCallback
+    return VK_FALSE;
+}
+
+void PerformanceWarnings::record(VkDebugUtilsMessageSeverityFlagBitsEXT severity, const VkDebugUtilsMessengerCallbackDataEXT& data)
+{
+    std::lock_guard lock(mMutex);
+
+    // NOTE Messages without an id (0) are gathered together, they are not expected from the validation layers
+    auto [finder, inserted] = mIndices.try_emplace(data.messageIdNumber, mWarnings.size());
+    if (inserted)
+    {
+        mWarnings.push_back(Warning{
+            .id          = data.messageIdNumber,
+            .name        = (data.pMessageIdName != nullptr) ? data.pMessageIdName : "",
+            .message     = (data.pMessage       != nullptr) ? data.pMessage       : "",
+            .severity    = severity,
+            .objects     = {},
+            .first_frame = mFrame,
+        });
+    }
+
+    Warning& warning = mWarnings[finder->second];
+    warning.count         += 1;
+    warning.pending_count += 1;
+    warning.last_frame     = mFrame;
+
+    for (std::uint32_t idx = 0; (idx < data.objectCount) && (warning.objects.size() < kObjectCapacity); ++idx)
+    {
+        std::string object = describe(data.pObjects[idx]);
+        if (std::ranges::find(warning.objects, object) == std::end(warning.objects))
+            warning.objects.push_back(std::move(object));
+    }
+}
+
+void PerformanceWarnings::begin_frame()
+{
+    std::lock_guard lock(mMutex);
+    for (auto&& warning : mWarnings)
+        warning.frame_count = std::exchange(warning.pending_count, 0);
+    ++mFrame;
+}
+
+std::vector<PerformanceWarnings::Warning> PerformanceWarnings::warnings() const
+{
+    std::lock_guard lock(mMutex);
+    return mWarnings;
+}
+
+void PerformanceWarnings::report(std::ostream& stream) const
+{
+    std::vector<Warning> sorted = warnings();
+    std::ranges::stable_sort(sorted, std::ranges::greater{}, &Warning::count);
+
+    std::uint64_t total = 0;
+    for (auto&& warning : sorted)
+        total += warning.count;
+
+    stream << "Performance Warnings: " << sorted.size() << " distinct, " << total << " occurrences" << std::endl;
+    for (auto&& warning : sorted)
+    {
+        stream << "  " << warning.count << "x "
+               << VkDebugUtilsMessageSeverityFlagBitsEXTString(warning.severity) << ' '
+               << warning.name << " (" << warning.id << "), frames " << warning.first_frame << '-' << warning.last_frame << '\n'
+               << "    " << warning.message << '\n';
+        if (!warning.objects.empty())
+        {
+            stream << "    Objects:";
+            for (auto&& object : warning.objects)
+                stream << " [" << object << ']';
+            stream << '\n';
+        }
+    }
+    stream << std::flush;
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <unordered_map>
+
+namespace blk
+{
+    // Performance messages of the validation layers (e.g. best practices), deduplicated by message id, see VulkanApplication
+    //  NOTE Messages may be reported from any thread, e.g. pipeline compilation
+    struct PerformanceWarnings
+    {
+        // Distinct objects kept per warning
+        static constexpr std::size_t kObjectCapacity = 8;
+
+        struct Warning
+        {
+            // VkDebugUtilsMessengerCallbackDataEXT::messageIdNumber
+            std::int32_t                           id;
+            std::string                            name;
+            // First occurrence, later ones usually differ only by the objects involved
+            std::string                            message;
+            VkDebugUtilsMessageSeverityFlagBitsEXT severity;
+            // Debug name when set (see blk::debug::name), object type and handle otherwise
+            std::vector<std::string>               objects;
+            std::uint64_t                          count         = 0;
+            // Occurrences during the latest complete frame
+            std::uint32_t                          frame_count   = 0;
+            std::uint32_t                          pending_count = 0;
+            std::uint64_t                          first_frame   = 0;
+            std::uint64_t                          last_frame    = 0;
+        };
+
+        static PerformanceWarnings& instance();
+
+        // Messenger callback, pUserData is the collector
+        static VKAPI_ATTR VkBool32 VKAPI_CALL callback(
+            VkDebugUtilsMessageSeverityFlagBitsEXT      messageSeverity,
+            VkDebugUtilsMessageTypeFlagsEXT             messageType,
+            const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
+            void*                                       pUserData);
+
+        void record(VkDebugUtilsMessageSeverityFlagBitsEXT severity, const VkDebugUtilsMessengerCallbackDataEXT& data);
+
+        // Close the per-frame counters of the previous frame
+        void begin_frame();
+
+        // Copy, in order of first occurrence
+        [[nodiscard]] std::vector<Warning> warnings() const;
+
+        // Human readable summary, most frequent first
+        void report(std::ostream& stream) const;
+
+        mutable std::mutex                            mMutex;
+        std::vector<Warning>                          mWarnings;
+        std::unordered_map<std::int32_t, std::size_t> mIndices;
+        std::uint64_t                                 mFrame = 0;
+    };
+}
@@ -0,0 +1,145 @@
+#include "./vkpipelinecompiler.hpp"
+
+#include "./vkprofiler.hpp"
+#include "./vkstartupprofiler.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cassert>
+
+#include <chrono>
+#include <utility>
+#include <algorithm>
+
+namespace
+{
+    bool is_ready(const blk::PipelineCompiler::future_t& future)
+    {
+        return future.valid()
+            && (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    }
+}
+
+namespace blk
+{
+
+PipelineCompiler::PipelineCompiler(std::uint32_t thread_count)
+{
+    // NOTE hardware_concurrency may return 0 when not computable
+    thread_count = std::max(thread_count, 1u);
+    mWorkers.reserve(thread_count);
+    for (std::uint32_t idx = 0; idx < thread_count; ++idx)
+        mWorkers.emplace_back(&PipelineCompiler::work, this);
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+    {
+        std::lock_guard lock(mMutex);
+        mStopping = true;
+    }
+    mJobCondition.notify_all();
+    for (auto&& worker : mWorkers)
+        worker.join();
+}
+
+PipelineCompiler::future_t PipelineCompiler::compile(job_t job)
+{
+    std::packaged_task<VkPipeline()> task(std::move(job));
+    future_t future = task.get_future().share();
+    {
+        std::lock_guard lock(mMutex);
+        assert(!mStopping);
+        mJobs.push_back(std::move(task));
+    }
+    mJobCondition.notify_one();
+    return future;
+}
+
+void PipelineCompiler::work()
+{
+    BLK_PROFILE_THREAD("Pipeline Compiler");
+    while (true)
+    {
+        std::packaged_task<VkPipeline()> task;
+        {
+            std::unique_lock lock(mMutex);
+            mJobCondition.wait(lock, [this]{ return mStopping || !mJobs.empty(); });
+            if (mJobs.empty())
+                return;
+
+            task = std::move(mJobs.front());
+            mJobs.pop_front();
+        }
+
+        {
+            BLK_PROFILE_ZONE("PipelineCompiler::compile");
+            const blk::StartupPhase phase("Pipeline");
+            task();
+        }
+    }
+}
+
+void AsyncPipeline::compile(PipelineCompiler& compiler, PipelineCompiler::job_t job)
+{
+    if (mPending.valid())
+        mSuperseded.push_back(std::exchange(mPending, {}));
+    mPending = compiler.compile(std::move(job));
+}
+
+VkPipeline AsyncPipeline::acquire()
+{
+    {// Superseded compilations
+        auto finder = std::remove_if(
+            std::begin(mSuperseded), std::end(mSuperseded),
+            [this](const PipelineCompiler::future_t& future) {
+                if (!is_ready(future))
+                    return false;
+                vkDestroyPipeline(mDevice, future.get(), nullptr);
+                return true;
+            }
+        );
+        mSuperseded.erase(finder, std::end(mSuperseded));
+    }
+    if (is_ready(mPending))
+    {
+        VkPipeline compiled = std::exchange(mPending, {}).get();
+        // NOTE Keep the fallback when the compilation failed
+        if (compiled != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(mDevice, mPipeline, nullptr);
+            mPipeline = compiled;
+        }
+    }
+    return mPipeline;
+}
+
+bool AsyncPipeline::pending() const
+{
+    return mPending.valid();
+}
+
+void AsyncPipeline::wait()
+{
+    if (mPending.valid())
+        mPending.wait();
+    for (auto&& future : mSuperseded)
+        future.wait();
+}
+
+void AsyncPipeline::destroy()
+{
+    wait();
+    for (auto&& future : mSuperseded)
+        vkDestroyPipeline(mDevice, future.get(), nullptr);
+    mSuperseded.clear();
+    if (mPending.valid())
+        vkDestroyPipeline(mDevice, std::exchange(mPending, {}).get(), nullptr);
+    if (mPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(mDevice, mPipeline, nullptr);
+        mPipeline = VK_NULL_HANDLE;
+    }
+}
+
+}
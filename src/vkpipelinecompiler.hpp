@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cinttypes>
+
+#include <deque>
+#include <mutex>
+#include <future>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+namespace blk
+{
+    // Compile pipelines on a pool of worker threads, so that pass construction / resize does not block the frame
+    //  A job builds its create info and returns the created pipeline
+    //  NOTE Jobs CHECK pipeline creation, a failure is fatal in debug, VK_NULL_HANDLE is returned otherwise (see AsyncPipeline::acquire)
+    struct PipelineCompiler
+    {
+        using job_t    = std::function<VkPipeline()>;
+        using future_t = std::shared_future<VkPipeline>;
+
+        explicit PipelineCompiler(std::uint32_t thread_count = std::thread::hardware_concurrency());
+        ~PipelineCompiler();
+
+        PipelineCompiler(const PipelineCompiler& rhs) = delete;
+        PipelineCompiler& operator=(const PipelineCompiler& rhs) = delete;
+
+        [[nodiscard]] future_t compile(job_t job);
+
+        void work();
+
+        std::mutex                               mMutex;
+        std::condition_variable                  mJobCondition;
+        std::deque<std::packaged_task<VkPipeline()>> mJobs;
+        bool                                     mStopping    = false;
+
+        std::vector<std::thread>                 mWorkers;
+    };
+
+    // Pipeline whose compilation may still be in flight
+    //  Until the compiled pipeline is ready, the previous one (if any) is kept as fallback
+    struct AsyncPipeline
+    {
+        VkDevice                              mDevice   = VK_NULL_HANDLE;
+        VkPipeline                            mPipeline = VK_NULL_HANDLE;
+        PipelineCompiler::future_t            mPending;
+        // Compilations replaced by a newer request, destroyed once they complete
+        std::vector<PipelineCompiler::future_t> mSuperseded;
+
+        constexpr AsyncPipeline() = default;
+
+        explicit AsyncPipeline(VkDevice vkdevice)
+            : mDevice(vkdevice)
+        {
+        }
+
+        AsyncPipeline(const AsyncPipeline& rhs) = delete;
+        AsyncPipeline& operator=(const AsyncPipeline& rhs) = delete;
+
+        ~AsyncPipeline()
+        {
+            destroy();
+        }
+
+        void compile(PipelineCompiler& compiler, PipelineCompiler::job_t job);
+
+        // Adopt a completed compilation, if any, and return the pipeline to draw with (VK_NULL_HANDLE if none is ready yet)
+        // NOTE Caller must guarantee the previous pipeline is no longer in use by the device
+        VkPipeline acquire();
+
+        bool pending() const;
+
+        void wait();
+
+        void destroy();
+    };
+}
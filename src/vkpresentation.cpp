@@ -1,11 +1,14 @@
 #include "./vkpresentation.hpp"
 
 #include "./vkdebug.hpp"
+#include "./vkdebugutils.hpp"
 
 #include "./vkqueue.hpp"
 #include "./vkengine.hpp"
 #include "./vksurface.hpp"
 #include "./vkphysicaldevice.hpp"
+#include "./vkprofiler.hpp"
+#include "./vkstartupprofiler.hpp"
 
 #include <vulkan/vulkan_core.h>
 
@@ -13,19 +16,37 @@
 
 #include <array>
 #include <vector>
+#include <utility>
+#include <algorithm>
 
 #include <ranges>
 
 namespace
 {
-    constexpr bool kVSync = true;
-
-    constexpr std::array kPreferredPresentModes = {
-        VK_PRESENT_MODE_MAILBOX_KHR,
-        VK_PRESENT_MODE_IMMEDIATE_KHR,
-        VK_PRESENT_MODE_FIFO_KHR,
+    using blk::PresentPolicy;
+
+    struct PresentPolicyTraits
+    {
+        const char*                     name;
+        // By preference, FIFO is guaranteed by spec
+        std::array<VkPresentModeKHR, 3> modes;
+        // Images on top of the surface minimum
+        std::uint32_t                   extra_images;
     };
 
+    constexpr PresentPolicyTraits traits(PresentPolicy policy)
+    {
+        switch (policy)
+        {
+            // NOTE Mailbox needs a spare image to always have one to render into
+            case PresentPolicy::LowLatency : return { "low-latency" , { VK_PRESENT_MODE_MAILBOX_KHR     , VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_KHR }, 1 };
+            case PresentPolicy::Throughput : return { "throughput"  , { VK_PRESENT_MODE_IMMEDIATE_KHR   , VK_PRESENT_MODE_MAILBOX_KHR  , VK_PRESENT_MODE_FIFO_KHR }, 1 };
+            // NOTE Minimal buffering, frames are throttled by presentation anyway
+            case PresentPolicy::PowerSaving:
+            default                        : return { "power-saving", { VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR     , VK_PRESENT_MODE_FIFO_KHR }, 0 };
+        }
+    }
+
     constexpr std::array kPreferredCompositeAlphaFlags{
         VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
         VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR,
@@ -39,10 +60,30 @@ namespace
 namespace blk
 {
 
+const char* PresentPolicy2Text(PresentPolicy policy)
+{
+    return traits(policy).name;
+}
+
+std::optional<PresentPolicy> parse_present_policy(const std::string_view& text)
+{
+    auto finder = std::ranges::find_if(
+        kPresentPolicies,
+        [&text](PresentPolicy policy) {
+            return text == traits(policy).name;
+        }
+    );
+    if (finder != std::end(kPresentPolicies))
+        return *finder;
+    else
+        return { };
+}
+
 Presentation::Presentation(
-    const blk::Engine& vkengine,
+    blk::Engine& vkengine,
     const blk::Surface& vksurface,
-    const VkExtent2D& resolution)
+    const VkExtent2D& resolution,
+    PresentPolicy policy)
     : mEngine(vkengine)
     , mSurface(vksurface)
     , mResolution(resolution)
@@ -51,33 +92,16 @@ Presentation::Presentation(
     , mPhysicalDevice(vkengine.mPhysicalDevice)
 
     , mPresentationQueues(vkengine.mPresentationQueues)
+
+    , mPresentPolicy(policy)
 {
     {// Present Modes
-        mPresentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
-        if (kVSync)
-        {
-            // guaranteed by spec
-            mPresentMode = VK_PRESENT_MODE_FIFO_KHR;
-        }
-        else
-        {
-            std::uint32_t count;
-            CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice, mSurface, &count, nullptr));
-            assert(count > 0);
-
-            std::vector<VkPresentModeKHR> present_modes(count);
-            CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice, mSurface, &count, present_modes.data()));
+        std::uint32_t count;
+        CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice, mSurface, &count, nullptr));
+        assert(count > 0);
 
-            for (auto&& preferred : kPreferredPresentModes)
-            {
-                auto finder_present_mode = std::ranges::find(present_modes, preferred);
-                if (finder_present_mode != std::end(present_modes))
-                {
-                    mPresentMode = *finder_present_mode;
-                }
-            }
-            assert(mPresentMode != VK_PRESENT_MODE_MAX_ENUM_KHR);
-        }
+        mPresentModes.resize(count);
+        CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice, mSurface, &count, mPresentModes.data()));
     }
     {// Formats
         {// Color Attachment
@@ -146,6 +170,9 @@ Presentation::Presentation(
 
 Presentation::~Presentation()
 {
+    // NOTE Retired command buffers belong to our pool
+    mEngine.mRetireQueue.flush();
+
     vkDestroySwapchainKHR(mDevice, mSwapchain, nullptr);
 
     vkDestroyCommandPool(mDevice, mCommandPool, nullptr);
@@ -155,6 +182,9 @@ Presentation::~Presentation()
 
 VkExtent2D Presentation::recreate_swapchain()
 {
+    // NOTE Only the initial creation is part of startup, see StartupProfiler::finish
+    const blk::StartupPhase phase("Swapchain");
+
     VkSurfaceCapabilitiesKHR capabilities;
     CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(mPhysicalDevice, mSurface, &capabilities));
 
@@ -162,12 +192,19 @@ VkExtent2D Presentation::recreate_swapchain()
         ? mResolution
         : capabilities.currentExtent;
 
+    const PresentPolicyTraits policy = traits(mPresentPolicy);
+
+    {// Present Mode
+        // NOTE First supported mode by preference, FIFO is always available
+        auto finder = std::ranges::find_first_of(policy.modes, mPresentModes);
+        mPresentMode = (finder != std::end(policy.modes)) ? *finder : VK_PRESENT_MODE_FIFO_KHR;
+    }
     {// Creation
         VkSwapchainKHR previous_swapchain = mSwapchain;
 
         const std::uint32_t image_count = (capabilities.maxImageCount > 0)
-            ? std::min(capabilities.minImageCount + 1, capabilities.maxImageCount)
-            : capabilities.minImageCount + 1;
+            ? std::min(capabilities.minImageCount + policy.extra_images, capabilities.maxImageCount)
+            : capabilities.minImageCount + policy.extra_images;
 
         const VkSurfaceTransformFlagBitsKHR transform = (capabilities.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
             ? VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR
@@ -193,6 +230,8 @@ VkExtent2D Presentation::recreate_swapchain()
         if (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)
             usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
+        mImageUsage = usage;
+
         const VkSwapchainCreateInfoKHR info{
             .sType                 = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
             .pNext                 = nullptr,
@@ -217,21 +256,29 @@ VkExtent2D Presentation::recreate_swapchain()
 
         if (previous_swapchain != VK_NULL_HANDLE)
         {// Cleaning
-            if (!mCommandBuffers.empty())
-                vkFreeCommandBuffers(
-                    mDevice,
-                    mCommandPool,
-                    static_cast<std::uint32_t>(mCommandBuffers.size()),
-                    mCommandBuffers.data()
-                );
-            mCommandBuffers.clear();
-            vkDestroySwapchainKHR(mDevice, previous_swapchain, nullptr);
+            // NOTE Latest frame may still use them
+            //  Its fence does not cover the latest present, only an idle queue does
+            mEngine.mRetireQueue.retire(
+                [device = mDevice, queue = static_cast<VkQueue>(*mPresentationQueues.at(0)), pool = mCommandPool, swapchain = previous_swapchain, commandbuffers = std::exchange(mCommandBuffers, {})]{
+                    CHECK(vkQueueWaitIdle(queue));
+                    if (!commandbuffers.empty())
+                        vkFreeCommandBuffers(
+                            device,
+                            pool,
+                            static_cast<std::uint32_t>(commandbuffers.size()),
+                            commandbuffers.data()
+                        );
+                    vkDestroySwapchainKHR(device, swapchain, nullptr);
+                }
+            );
         }
     }
     {// Views
         CHECK(vkGetSwapchainImagesKHR(mDevice, mSwapchain, &mImageCount, nullptr));
         mImages.resize(mImageCount);
         CHECK(vkGetSwapchainImagesKHR(mDevice, mSwapchain, &mImageCount, mImages.data()));
+        for (auto&& image : mImages)
+            blk::debug::name(mDevice, image, "Swapchain");
     }
     { // Command Buffers
         mCommandBuffers.resize(mImageCount);
@@ -243,6 +290,8 @@ VkExtent2D Presentation::recreate_swapchain()
             .commandBufferCount = static_cast<std::uint32_t>(mCommandBuffers.size()),
         };
         CHECK(vkAllocateCommandBuffers(mDevice, &info, mCommandBuffers.data()));
+        for (auto&& commandbuffer : mCommandBuffers)
+            blk::debug::name(mDevice, commandbuffer, "Presentation");
     }
 
     return mResolution;
@@ -250,6 +299,7 @@ VkExtent2D Presentation::recreate_swapchain()
 
 blk::Presentation::Image Presentation::acquire_next(std::uint64_t timeout)
 {
+    BLK_PROFILE_ZONE("Presentation::acquire_next");
     std::uint32_t index = ~0;
     const VkResult status = vkAcquireNextImageKHR(
         mDevice,
@@ -269,11 +319,24 @@ blk::Presentation::Image Presentation::acquire_next(std::uint64_t timeout)
     };
 }
 
-VkResult Presentation::present(const Image& presentation_image, VkSemaphore wait_semaphore)
+VkResult Presentation::present(const Image& presentation_image, VkSemaphore wait_semaphore, std::uint64_t present_id)
 {
+    BLK_PROFILE_ZONE("Presentation::present");
+    const void* next = nullptr;
+    #if defined(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+    const VkPresentIdKHR info_id{
+        .sType          = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+        .pNext          = nullptr,
+        .swapchainCount = 1,
+        .pPresentIds    = &present_id,
+    };
+    if ((present_id != 0) && mEngine.mPresentWait)
+        next = &info_id;
+    #endif
+
     const VkPresentInfoKHR info{
         .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .pNext              = nullptr,
+        .pNext              = next,
         .waitSemaphoreCount = 1,
         .pWaitSemaphores    = &wait_semaphore,
         .swapchainCount     = 1,
@@ -291,6 +354,12 @@ VkResult Presentation::present(const Image& presentation_image, VkSemaphore wait
     return result_present;
 }
 
+VkExtent2D Presentation::set_present_policy(PresentPolicy policy)
+{
+    mPresentPolicy = policy;
+    return recreate_swapchain();
+}
+
 void Presentation::onResize(const VkExtent2D& resolution)
 {
     mResolution = resolution;
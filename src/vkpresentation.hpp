@@ -5,7 +5,10 @@
 #include <cinttypes>
 
 #include <span>
+#include <array>
 #include <vector>
+#include <optional>
+#include <string_view>
 
 #include "./vkutilities.hpp"
 
@@ -16,6 +19,27 @@ struct Queue;
 struct Engine;
 struct Surface;
 
+// How frames are handed to the presentation engine, each policy maps to preferred present modes
+//  - LowLatency  : MAILBOX, newest frame replaces queued one, no tearing
+//  - Throughput  : IMMEDIATE, uncapped frame rate, may tear
+//  - PowerSaving : FIFO (RELAXED), capped to refresh rate
+enum class PresentPolicy : std::uint32_t
+{
+    LowLatency,
+    Throughput,
+    PowerSaving,
+};
+
+constexpr std::array kPresentPolicies{
+    PresentPolicy::LowLatency,
+    PresentPolicy::Throughput,
+    PresentPolicy::PowerSaving,
+};
+
+[[nodiscard]] const char* PresentPolicy2Text(PresentPolicy policy);
+// Parse the command-line names, i.e. low-latency, throughput, power-saving
+[[nodiscard]] std::optional<PresentPolicy> parse_present_policy(const std::string_view& text);
+
 struct Presentation
 {
     struct Image
@@ -32,19 +56,25 @@ struct Presentation
     };
 
     explicit Presentation(
-        const blk::Engine& vkengine,
+        blk::Engine& vkengine,
         const blk::Surface& vksurface,
-        const VkExtent2D& resolution);
+        const VkExtent2D& resolution,
+        PresentPolicy policy = PresentPolicy::PowerSaving);
     ~Presentation();
 
+    // NOTE Previous swapchain and its command buffers are retired, see Engine::mRetireQueue
     VkExtent2D recreate_swapchain();
 
+    // NOTE Swapchain images (and their count) change
+    VkExtent2D set_present_policy(PresentPolicy policy);
+
     [[nodiscard]] Image acquire_next(std::uint64_t timeout);
-    [[nodiscard]] VkResult present(const Image&, VkSemaphore wait_semaphore);
+    // NOTE present_id is only forwarded when VK_KHR_present_id is enabled, 0 means untagged
+    [[nodiscard]] VkResult present(const Image&, VkSemaphore wait_semaphore, std::uint64_t present_id = 0);
 
     void onResize(const VkExtent2D& resolution);
 
-    const blk::Engine&           mEngine;
+    blk::Engine&                 mEngine;
     const blk::Surface&          mSurface;
     VkExtent2D                   mResolution;
 
@@ -55,7 +85,12 @@ struct Presentation
 
     VkFormat                     mColorFormat   = VK_FORMAT_UNDEFINED;
     VkColorSpaceKHR              mColorSpace    = VK_COLOR_SPACE_MAX_ENUM_KHR;
+    // Swapchain images usage, e.g. to describe imageless framebuffer attachments
+    VkImageUsageFlags            mImageUsage    = 0;
     VkPresentModeKHR             mPresentMode   = VK_PRESENT_MODE_MAX_ENUM_KHR;
+    PresentPolicy                mPresentPolicy;
+    // Supported by the surface
+    std::vector<VkPresentModeKHR> mPresentModes;
 
     // FIXME To scale, we would need to have an array of semaphore present/complete if we want to process frame as fast as possible
     VkSemaphore                  mAcquiredSemaphore = VK_NULL_HANDLE;
@@ -0,0 +1,139 @@
+#include "./vkprofiler.hpp"
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <string_view>
+
+#include <json.hpp>
+
+namespace blk::profiler
+{
+
+Profiler& Profiler::instance()
+{
+    static Profiler sProfiler;
+    return sProfiler;
+}
+
+Ring& Profiler::ring()
+{
+    // NOTE Rings are owned by the profiler, zones of exited threads can still be drained
+    thread_local Ring* tRing = nullptr;
+    if (tRing == nullptr)
+    {
+        std::lock_guard lock(mMutex);
+        tRing = mRings.emplace_back(std::make_unique<Ring>(static_cast<std::uint32_t>(mRings.size()))).get();
+        mThreadNames.emplace_back("Thread " + std::to_string(tRing->mThread));
+    }
+    return *tRing;
+}
+
+void Profiler::name_thread(const char* name)
+{
+    const Ring& local = ring();
+    std::lock_guard lock(mMutex);
+    mThreadNames.at(local.mThread) = name;
+}
+
+void Profiler::gpu_zone(const char* name, std::uint64_t begin, std::uint64_t end, std::uint32_t depth)
+{
+    if (mGpuRing == nullptr)
+    {
+        std::lock_guard lock(mMutex);
+        mGpuRing = mRings.emplace_back(std::make_unique<Ring>(static_cast<std::uint32_t>(mRings.size()))).get();
+        mThreadNames.emplace_back("GPU");
+    }
+    mGpuRing->push(Zone{
+        .name  = name,
+        .begin = begin,
+        .end   = end,
+        .depth = depth,
+    });
+}
+
+void Profiler::begin_frame()
+{
+    const std::uint64_t tick = now();
+    const std::size_t drained = mHistory.size();
+
+    {// Drain
+        std::lock_guard lock(mMutex);
+        for (auto&& ring : mRings)
+        {
+            ring->drain([this, thread = ring->mThread](const Zone& zone) {
+                mHistory.push_back(Record{ .zone = zone, .thread = thread });
+            });
+        }
+        mDropped = 0;
+        for (auto&& ring : mRings)
+            mDropped += ring->mDropped.load(std::memory_order_relaxed);
+    }
+
+    {// Latest complete frame
+        mFrameBegin = std::exchange(mFrameEnd, tick);
+        mFrame.clear();
+        // NOTE Zones drained earlier completed before the frame, zones still running are left out
+        //  GPU ranges are only known once a later frame fetched them, they may start before the frame
+        for (auto record = std::next(std::begin(mHistory), static_cast<std::ptrdiff_t>(drained)); record != std::end(mHistory); ++record)
+        {
+            if ((record->zone.end > mFrameBegin) && (record->zone.begin < mFrameEnd))
+                mFrame.push_back(*record);
+        }
+        std::ranges::sort(mFrame, [](const Record& lhs, const Record& rhs) {
+            return (lhs.thread != rhs.thread) ? (lhs.thread < rhs.thread) : (lhs.zone.begin < rhs.zone.begin);
+        });
+    }
+
+    while (mHistory.size() > kHistoryCapacity)
+        mHistory.pop_front();
+}
+
+void Profiler::export_chrome_trace(std::ostream& stream)
+{
+    // NOTE Timestamps are microseconds, relative to the oldest zone kept
+    const std::uint64_t origin = mHistory.empty() ? 0 : std::ranges::min(mHistory, {}, [](const Record& record) { return record.zone.begin; }).zone.begin;
+
+    const auto flags     = stream.flags();
+    const auto precision = stream.precision();
+    stream << std::fixed;
+    stream.precision(3);
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    {// Thread names
+        std::lock_guard lock(mMutex);
+        for (std::uint32_t thread = 0; thread < mThreadNames.size(); ++thread)
+        {
+            stream << (first ? "\n" : ",\n")
+                   << "{\"ph\":\"M\",\"pid\":0,\"tid\":" << thread << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            stream << json_string(mThreadNames[thread]);
+            stream << "}}";
+            first = false;
+        }
+    }
+    for (auto&& record : mHistory)
+    {
+        stream << (first ? "\n" : ",\n")
+               << "{\"ph\":\"X\",\"pid\":0,\"tid\":" << record.thread
+               << ",\"ts\":"  << static_cast<double>(record.zone.begin - origin) * 1e-3
+               << ",\"dur\":" << static_cast<double>(record.zone.end - record.zone.begin) * 1e-3
+               << ",\"name\":";
+        stream << json_string(record.zone.name);
+        stream << '}';
+        first = false;
+    }
+    stream << "\n]}" << std::endl;
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+}
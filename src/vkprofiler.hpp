@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cinttypes>
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+
+// CPU scoped zones, e.g. BLK_PROFILE_ZONE("Sample::record") at the top of a scope
+//  NOTE Compiled out unless BLK_PROFILING is defined, see ENABLE_PROFILING
+#if defined(BLK_PROFILING)
+    #define BLK_PROFILE_CONCAT_IMPL(lhs, rhs) lhs##rhs
+    #define BLK_PROFILE_CONCAT(lhs, rhs) BLK_PROFILE_CONCAT_IMPL(lhs, rhs)
+    // NOTE name must outlive the profiler, i.e. a string literal
+    #define BLK_PROFILE_ZONE(name) const ::blk::profiler::ScopedZone BLK_PROFILE_CONCAT(blk_profile_zone_, __LINE__)(name)
+    #define BLK_PROFILE_THREAD(name) ::blk::profiler::Profiler::instance().name_thread(name)
+    #define BLK_PROFILE_FRAME() ::blk::profiler::Profiler::instance().begin_frame()
+#else
+    #define BLK_PROFILE_ZONE(name) ((void)0)
+    #define BLK_PROFILE_THREAD(name) ((void)0)
+    #define BLK_PROFILE_FRAME() ((void)0)
+#endif
+
+namespace blk::profiler
+{
+    #if defined(BLK_PROFILING)
+    constexpr bool kEnabled = true;
+    #else
+    constexpr bool kEnabled = false;
+    #endif
+
+    using clock_t = std::chrono::steady_clock;
+
+    // Nanoseconds since clock_t epoch
+    [[nodiscard]] inline std::uint64_t now()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now().time_since_epoch()).count());
+    }
+
+    struct Zone
+    {
+        const char*   name;
+        std::uint64_t begin;
+        std::uint64_t end;
+        // Enclosing zones count on the same thread
+        std::uint32_t depth;
+    };
+
+    // Zones completed by a single thread (producer), drained by the collector (consumer)
+    //  NOTE Lock-free, zones are dropped when the collector falls behind
+    struct Ring
+    {
+        static constexpr std::uint64_t kCapacity = 1 << 12;
+        static_assert((kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of two");
+
+        explicit Ring(std::uint32_t thread)
+            : mThread(thread)
+        {
+        }
+
+        Ring(const Ring& rhs) = delete;
+        Ring& operator=(const Ring& rhs) = delete;
+
+        // Producer only
+        void push(const Zone& zone)
+        {
+            const std::uint64_t head = mHead.load(std::memory_order_relaxed);
+            if (head - mTail.load(std::memory_order_acquire) >= kCapacity)
+            {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            mZones[head & (kCapacity - 1)] = zone;
+            mHead.store(head + 1, std::memory_order_release);
+        }
+
+        // Consumer only
+        template<typename Consumer>
+        void drain(Consumer&& consumer)
+        {
+            const std::uint64_t tail = mTail.load(std::memory_order_relaxed);
+            const std::uint64_t head = mHead.load(std::memory_order_acquire);
+            for (std::uint64_t idx = tail; idx != head; ++idx)
+                consumer(mZones[idx & (kCapacity - 1)]);
+            mTail.store(head, std::memory_order_release);
+        }
+
+        const std::uint32_t                      mThread;
+        // Producer only, see ScopedZone
+        std::uint32_t                            mDepth   = 0;
+
+        std::array<Zone, kCapacity>              mZones;
+        // NOTE Separate cache lines, written by different threads
+        alignas(64) std::atomic<std::uint64_t>   mHead    = 0;
+        alignas(64) std::atomic<std::uint64_t>   mTail    = 0;
+        std::atomic<std::uint64_t>               mDropped = 0;
+    };
+
+    struct Record
+    {
+        Zone          zone;
+        std::uint32_t thread;
+    };
+
+    // Collects the zones of every thread, frame by frame
+    //  NOTE Every function but ring and name_thread is meant for the main thread
+    struct Profiler
+    {
+        // Zones kept for export, the oldest ones are discarded first
+        static constexpr std::size_t kHistoryCapacity = 1 << 16;
+
+        [[nodiscard]] static Profiler& instance();
+
+        // Calling thread ring, registered on first use
+        [[nodiscard]] Ring& ring();
+        void name_thread(const char* name);
+
+        // GPU range already mapped onto the profiler clock, see blk::TimestampCalibration
+        //  NOTE Main thread only, ranges are recorded into the "GPU" lane
+        void gpu_zone(const char* name, std::uint64_t begin, std::uint64_t end, std::uint32_t depth = 0);
+
+        // Drain every ring, the frame started by the previous call is then complete
+        void begin_frame();
+
+        // Chrome trace-event format, see chrome://tracing or https://ui.perfetto.dev
+        void export_chrome_trace(std::ostream& stream);
+
+        // Guards registration and thread names
+        std::mutex                         mMutex;
+        std::vector<std::unique_ptr<Ring>> mRings;
+        std::vector<std::string>           mThreadNames;
+        Ring*                              mGpuRing    = nullptr;
+
+        std::deque<Record>                 mHistory;
+        // Zones overlapping the latest complete frame
+        std::vector<Record>                mFrame;
+        std::uint64_t                      mFrameBegin = 0;
+        std::uint64_t                      mFrameEnd   = 0;
+        // Zones lost by full rings, in total
+        std::uint64_t                      mDropped    = 0;
+    };
+
+    struct ScopedZone
+    {
+        explicit ScopedZone(const char* name)
+            : mRing(Profiler::instance().ring())
+            , mName(name)
+            , mDepth(mRing.mDepth++)
+            , mBegin(now())
+        {
+        }
+
+        ~ScopedZone()
+        {
+            const std::uint64_t end = now();
+            --mRing.mDepth;
+            mRing.push(Zone{
+                .name  = mName,
+                .begin = mBegin,
+                .end   = end,
+                .depth = mDepth,
+            });
+        }
+
+        ScopedZone(const ScopedZone& rhs) = delete;
+        ScopedZone& operator=(const ScopedZone& rhs) = delete;
+
+        Ring&         mRing;
+        const char*   mName;
+        std::uint32_t mDepth;
+        std::uint64_t mBegin;
+    };
+}
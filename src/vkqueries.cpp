@@ -0,0 +1,268 @@
+#include "./vkqueries.hpp"
+
+#include "./vkdebug.hpp"
+
+#include "./vkengine.hpp"
+#include "./vkqueue.hpp"
+#include "./vkphysicaldevice.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#if defined(OS_WINDOWS)
+#include <windows.h>
+#endif
+
+#include <cassert>
+#include <cinttypes>
+
+#include <array>
+#include <chrono>
+#include <limits>
+
+namespace
+{
+    // NOTE Frame command buffers are allocated from, and submitted to, the presentation queue family (see Engine::mPresentationCommandPool)
+    std::uint32_t timestamp_valid_bits(const blk::Engine& vkengine)
+    {
+        return vkengine.mPresentationQueues.empty() ? 0 : vkengine.mPresentationQueues.at(0)->mFamily.mProperties.timestampValidBits;
+    }
+
+    // Signed distance between two timestamps of the given valid bits, robust to wrapping
+    std::int64_t timestamp_delta(std::uint64_t from, std::uint64_t to, std::uint32_t bits)
+    {
+        if (bits >= 64)
+            return static_cast<std::int64_t>(to - from);
+
+        const std::uint64_t mask  = (1ull << bits) - 1;
+        const std::uint64_t delta = (to - from) & mask;
+        // NOTE Upper half of the range is a negative distance
+        return (delta >> (bits - 1)) ? static_cast<std::int64_t>(delta) - static_cast<std::int64_t>(mask + 1) : static_cast<std::int64_t>(delta);
+    }
+}
+
+namespace blk
+{
+
+TimestampQueries::TimestampQueries(const blk::Engine& vkengine, std::uint32_t count)
+    : mDevice(vkengine.mDevice)
+    , mSupported(timestamp_valid_bits(vkengine) != 0)
+    , mPeriod(vkengine.mPhysicalDevice.mProperties.limits.timestampPeriod)
+    , mValidMask(timestamp_valid_bits(vkengine) >= 64 ? ~0ull : ((1ull << timestamp_valid_bits(vkengine)) - 1))
+    , mCount(count)
+    , mTimestamps(count, 0)
+{
+    if (!mSupported)
+        return;
+
+    const VkQueryPoolCreateInfo info{
+        .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .pNext              = nullptr,
+        .flags              = 0,
+        .queryType          = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount         = mCount,
+        .pipelineStatistics = 0,
+    };
+    CHECK(vkCreateQueryPool(mDevice, &info, nullptr, &mQueryPool));
+}
+
+TimestampQueries::~TimestampQueries()
+{
+    vkDestroyQueryPool(mDevice, mQueryPool, nullptr);
+}
+
+void TimestampQueries::reset(VkCommandBuffer commandbuffer)
+{
+    if (!mSupported)
+        return;
+
+    vkCmdResetQueryPool(commandbuffer, mQueryPool, 0, mCount);
+    mPending = true;
+}
+
+void TimestampQueries::write(VkCommandBuffer commandbuffer, VkPipelineStageFlagBits stage, std::uint32_t index)
+{
+    assert(index < mCount);
+    if (!mSupported)
+        return;
+
+    vkCmdWriteTimestamp(commandbuffer, stage, mQueryPool, index);
+}
+
+bool TimestampQueries::fetch()
+{
+    // NOTE Queries are only defined once a reset was recorded
+    if (!mPending)
+        return false;
+
+    const VkResult result = vkGetQueryPoolResults(
+        mDevice, mQueryPool,
+        0, mCount,
+        mTimestamps.size() * sizeof(std::uint64_t), mTimestamps.data(),
+        sizeof(std::uint64_t),
+        VK_QUERY_RESULT_64_BIT
+    );
+    if (result == VK_NOT_READY)
+        return false;
+
+    CHECK(result);
+    mPending = false;
+    return true;
+}
+
+float TimestampQueries::elapsed(std::uint32_t begin, std::uint32_t end) const
+{
+    assert(begin < mCount);
+    assert(end < mCount);
+    const std::uint64_t ticks = (mTimestamps[end] - mTimestamps[begin]) & mValidMask;
+    return static_cast<float>(static_cast<double>(ticks) * mPeriod / 1'000'000.0);
+}
+
+PipelineStatisticsQueries::PipelineStatisticsQueries(const blk::Engine& vkengine, std::uint32_t count)
+    : mDevice(vkengine.mDevice)
+    , mSupported(vkengine.mPipelineStatistics)
+    , mCount(count)
+    , mStatistics(count, PipelineStatistics{})
+{
+    if (!mSupported)
+        return;
+
+    const VkQueryPoolCreateInfo info{
+        .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .pNext              = nullptr,
+        .flags              = 0,
+        .queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+        .queryCount         = mCount,
+        .pipelineStatistics = kStatistics,
+    };
+    CHECK(vkCreateQueryPool(mDevice, &info, nullptr, &mQueryPool));
+}
+
+PipelineStatisticsQueries::~PipelineStatisticsQueries()
+{
+    vkDestroyQueryPool(mDevice, mQueryPool, nullptr);
+}
+
+void PipelineStatisticsQueries::reset(VkCommandBuffer commandbuffer)
+{
+    if (!mSupported)
+        return;
+
+    vkCmdResetQueryPool(commandbuffer, mQueryPool, 0, mCount);
+    mPending = true;
+}
+
+void PipelineStatisticsQueries::begin(VkCommandBuffer commandbuffer, std::uint32_t index)
+{
+    assert(index < mCount);
+    if (!mSupported)
+        return;
+
+    vkCmdBeginQuery(commandbuffer, mQueryPool, index, 0);
+}
+
+void PipelineStatisticsQueries::end(VkCommandBuffer commandbuffer, std::uint32_t index)
+{
+    assert(index < mCount);
+    if (!mSupported)
+        return;
+
+    vkCmdEndQuery(commandbuffer, mQueryPool, index);
+}
+
+bool PipelineStatisticsQueries::fetch()
+{
+    // NOTE Every query must have been ended since the reset, otherwise results never become available
+    if (!mPending)
+        return false;
+
+    const VkResult result = vkGetQueryPoolResults(
+        mDevice, mQueryPool,
+        0, mCount,
+        mStatistics.size() * sizeof(PipelineStatistics), mStatistics.data(),
+        sizeof(PipelineStatistics),
+        VK_QUERY_RESULT_64_BIT
+    );
+    if (result == VK_NOT_READY)
+        return false;
+
+    CHECK(result);
+    mPending = false;
+    return true;
+}
+
+const PipelineStatistics& PipelineStatisticsQueries::statistics(std::uint32_t index) const
+{
+    assert(index < mCount);
+    return mStatistics[index];
+}
+
+TimestampCalibration::TimestampCalibration(const blk::Engine& vkengine)
+    : mEngine(vkengine)
+    , mSupported(vkengine.mCalibratedTimestamps && (timestamp_valid_bits(vkengine) != 0))
+    , mPeriod(vkengine.mPhysicalDevice.mProperties.limits.timestampPeriod)
+    , mValidBits(timestamp_valid_bits(vkengine))
+{
+    #if defined(OS_WINDOWS)
+    if (mSupported && (mEngine.mHostTimeDomain == VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT))
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        mHostFrequency = static_cast<std::uint64_t>(frequency.QuadPart);
+    }
+    #endif
+}
+
+bool TimestampCalibration::update()
+{
+    if (!mSupported)
+        return false;
+
+    const auto tick = std::chrono::steady_clock::now();
+    if (mCalibrated && (tick - mCalibrationTick < kRecalibrationInterval))
+        return true;
+
+    #if defined(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)
+    const std::array infos{
+        VkCalibratedTimestampInfoEXT{
+            .sType      = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT,
+            .pNext      = nullptr,
+            .timeDomain = VK_TIME_DOMAIN_DEVICE_EXT,
+        },
+        VkCalibratedTimestampInfoEXT{
+            .sType      = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT,
+            .pNext      = nullptr,
+            .timeDomain = mEngine.mHostTimeDomain,
+        },
+    };
+    // NOTE Sampling may be preempted, which shows up as a larger deviation
+    std::uint64_t deviation_min = std::numeric_limits<std::uint64_t>::max();
+    for (std::uint32_t idx = 0; idx < kSampleCount; ++idx)
+    {
+        std::array<std::uint64_t, infos.size()> timestamps{};
+        std::uint64_t deviation = 0;
+        CHECK(mEngine.mGetCalibratedTimestamps(mEngine.mDevice, static_cast<std::uint32_t>(infos.size()), infos.data(), timestamps.data(), &deviation));
+        if (deviation >= deviation_min)
+            continue;
+
+        deviation_min    = deviation;
+        mDeviceTimestamp = timestamps[0];
+        // NOTE Split to avoid overflowing, e.g. QueryPerformanceCounter ticks
+        mHostTimestamp   = (timestamps[1] / mHostFrequency) * 1'000'000'000ull
+                         + ((timestamps[1] % mHostFrequency) * 1'000'000'000ull) / mHostFrequency;
+    }
+    mDeviation       = deviation_min;
+    mCalibrated      = true;
+    mCalibrationTick = tick;
+    #endif
+
+    return mCalibrated;
+}
+
+std::uint64_t TimestampCalibration::host(std::uint64_t timestamp) const
+{
+    assert(mCalibrated);
+    const std::int64_t ticks = timestamp_delta(mDeviceTimestamp, timestamp, mValidBits);
+    return mHostTimestamp + static_cast<std::int64_t>(static_cast<double>(ticks) * mPeriod);
+}
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cinttypes>
+
+#include <chrono>
+#include <vector>
+
+namespace blk
+{
+    struct Engine;
+
+    // GPU timestamps written by a frame command buffer, read back once its submission completed
+    //  NOTE Single-buffered, results must be fetched before the next frame resets them
+    struct TimestampQueries
+    {
+        explicit TimestampQueries(const blk::Engine& vkengine, std::uint32_t count);
+        ~TimestampQueries();
+
+        TimestampQueries(const TimestampQueries& rhs) = delete;
+        TimestampQueries& operator=(const TimestampQueries& rhs) = delete;
+
+        // To record outside of any render pass, before any write
+        void reset(VkCommandBuffer commandbuffer);
+        void write(VkCommandBuffer commandbuffer, VkPipelineStageFlagBits stage, std::uint32_t index);
+
+        // Read back timestamps written since the latest reset, without waiting
+        //  Returns whether they were all available
+        bool fetch();
+        // Milliseconds elapsed between two fetched timestamps
+        [[nodiscard]] float elapsed(std::uint32_t begin, std::uint32_t end) const;
+
+        [[nodiscard]] constexpr bool supported() const
+        {
+            return mSupported;
+        }
+
+        VkDevice                   mDevice;
+        // Presentation queue family writes meaningful timestamps, they are written in presentation command buffers
+        const bool                 mSupported;
+        // Nanoseconds per timestamp increment
+        const float                mPeriod;
+        const std::uint64_t        mValidMask;
+        const std::uint32_t        mCount;
+
+        VkQueryPool                mQueryPool  = VK_NULL_HANDLE;
+        std::vector<std::uint64_t> mTimestamps;
+        // Reset was recorded since the latest fetch, i.e. results may be pending
+        bool                       mPending    = false;
+    };
+
+    // Pipeline statistics of a query, in the order of PipelineStatisticsQueries::kStatistics bits
+    //  NOTE Layout matches the results written by vkGetQueryPoolResults
+    struct PipelineStatistics
+    {
+        std::uint64_t input_assembly_vertices;
+        std::uint64_t input_assembly_primitives;
+        std::uint64_t vertex_shader_invocations;
+        std::uint64_t clipping_primitives;
+        std::uint64_t fragment_shader_invocations;
+    };
+
+    // Pipeline statistics of command ranges recorded into a frame command buffer, e.g. a subpass
+    //  NOTE Single-buffered, results must be fetched before the next frame resets them
+    struct PipelineStatisticsQueries
+    {
+        static constexpr VkQueryPipelineStatisticFlags kStatistics =
+              VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT
+            | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+        static_assert(sizeof(PipelineStatistics) == 5 * sizeof(std::uint64_t), "one counter per statistic bit");
+
+        explicit PipelineStatisticsQueries(const blk::Engine& vkengine, std::uint32_t count);
+        ~PipelineStatisticsQueries();
+
+        PipelineStatisticsQueries(const PipelineStatisticsQueries& rhs) = delete;
+        PipelineStatisticsQueries& operator=(const PipelineStatisticsQueries& rhs) = delete;
+
+        // To record outside of any render pass, before any begin
+        void reset(VkCommandBuffer commandbuffer);
+        // NOTE A query begun within a subpass must end within the same subpass
+        void begin(VkCommandBuffer commandbuffer, std::uint32_t index);
+        void end(VkCommandBuffer commandbuffer, std::uint32_t index);
+
+        // Read back statistics of the queries ended since the latest reset, without waiting
+        //  Returns whether they were all available
+        bool fetch();
+        [[nodiscard]] const PipelineStatistics& statistics(std::uint32_t index) const;
+
+        [[nodiscard]] constexpr bool supported() const
+        {
+            return mSupported;
+        }
+
+        VkDevice                        mDevice;
+        // Engine enabled pipelineStatisticsQuery
+        const bool                      mSupported;
+        const std::uint32_t             mCount;
+
+        VkQueryPool                     mQueryPool  = VK_NULL_HANDLE;
+        std::vector<PipelineStatistics> mStatistics;
+        bool                            mPending    = false;
+    };
+
+    // Map device timestamps onto the host clock behind std::chrono::steady_clock (VK_EXT_calibrated_timestamps)
+    //  NOTE Both clocks drift apart, the calibration is refreshed every kRecalibrationInterval
+    struct TimestampCalibration
+    {
+        static constexpr std::chrono::milliseconds kRecalibrationInterval{1000};
+        // Calibration samples, the least deviating one is kept
+        static constexpr std::uint32_t             kSampleCount = 3;
+
+        explicit TimestampCalibration(const blk::Engine& vkengine);
+
+        // Calibrate when due, returns whether host is meaningful
+        bool update();
+        // Host time of a device timestamp, in nanoseconds since the steady_clock epoch
+        [[nodiscard]] std::uint64_t host(std::uint64_t timestamp) const;
+
+        [[nodiscard]] constexpr bool supported() const
+        {
+            return mSupported;
+        }
+
+        const blk::Engine&         mEngine;
+        const bool                 mSupported;
+        // Nanoseconds per timestamp increment
+        const float                mPeriod;
+        const std::uint32_t        mValidBits;
+        // Host domain ticks per second
+        std::uint64_t              mHostFrequency   = 1'000'000'000;
+
+        bool                       mCalibrated      = false;
+        std::uint64_t              mDeviceTimestamp = 0;
+        // Nanoseconds
+        std::uint64_t              mHostTimestamp   = 0;
+        std::uint64_t              mDeviation       = 0;
+        std::chrono::steady_clock::time_point mCalibrationTick;
+    };
+}
@@ -0,0 +1,43 @@
+#include "./vkresolutionscaler.hpp"
+
+#include <cmath>
+#include <cinttypes>
+
+#include <algorithm>
+
+namespace blk
+{
+
+void ResolutionScaler::update(float gpu)
+{
+    if (!mEnabled)
+    {
+        mScale    = mMaxScale;
+        mFiltered = 0.0f;
+        return;
+    }
+
+    if ((gpu <= 0.0f) || (mTarget <= 0.0f))
+        return;
+
+    mFiltered = (mFiltered > 0.0f) ? (mFiltered + kSmoothing * (gpu - mFiltered)) : gpu;
+
+    const float ratio = mTarget / mFiltered;
+    if (std::abs(ratio - 1.0f) <= kTolerance)
+        return;
+
+    // NOTE Pixel count scales with the squared scale
+    const float desired = mScale * std::sqrt(ratio);
+    const float step    = std::clamp(desired / mScale, 1.0f - kMaxStep, 1.0f + kMaxStep);
+    mScale = std::clamp(mScale * step, mMinScale, mMaxScale);
+}
+
+VkExtent2D ResolutionScaler::scaled(const VkExtent2D& extent) const
+{
+    return VkExtent2D{
+        .width  = std::clamp(static_cast<std::uint32_t>(std::lround(extent.width  * mScale)), 1u, std::max(extent.width , 1u)),
+        .height = std::clamp(static_cast<std::uint32_t>(std::lround(extent.height * mScale)), 1u, std::max(extent.height, 1u)),
+    };
+}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+namespace blk
+{
+    // Dynamic resolution : adjust a render scale so that the measured GPU frame time converges toward a target
+    //  GPU time is assumed to grow with the rendered pixel count, i.e. the squared scale
+    struct ResolutionScaler
+    {
+        static constexpr float kMinScale  = 0.5f;
+        static constexpr float kMaxScale  = 1.0f;
+        // Relative scale change allowed per frame, avoids visible pumping
+        static constexpr float kMaxStep   = 0.05f;
+        // Relative distance to the target left uncorrected
+        static constexpr float kTolerance = 0.05f;
+        // Weight of the latest sample in the filtered GPU time
+        static constexpr float kSmoothing = 0.2f;
+
+        // Feed the GPU time (in milliseconds) of a frame rendered at the current scale
+        void update(float gpu);
+
+        // Extent rendered at the current scale, never empty
+        [[nodiscard]] VkExtent2D scaled(const VkExtent2D& extent) const;
+
+        // When disabled, the scale is reset to kMaxScale
+        bool  mEnabled  = false;
+        // In milliseconds
+        float mTarget   = 16.0f;
+        float mScale    = kMaxScale;
+        float mMinScale = kMinScale;
+        float mMaxScale = kMaxScale;
+        // Filtered GPU time, 0 until the first sample
+        float mFiltered = 0.0f;
+    };
+}
@@ -0,0 +1,46 @@
+#include "./vkretirequeue.hpp"
+
+#include <cinttypes>
+
+#include <utility>
+
+namespace blk
+{
+
+RetireQueue::~RetireQueue()
+{
+    flush();
+}
+
+void RetireQueue::retire(release_t release)
+{
+    mEntries.push_back(Entry{
+        .serial  = mSerial,
+        .release = std::move(release),
+    });
+}
+
+void RetireQueue::begin_frame(std::uint64_t completed)
+{
+    // NOTE Entries are ordered by serial
+    while (!mEntries.empty() && (mEntries.front().serial <= completed))
+    {
+        // NOTE A release may retire other objects
+        release_t release = std::move(mEntries.front().release);
+        mEntries.pop_front();
+        release();
+    }
+    ++mSerial;
+}
+
+void RetireQueue::flush()
+{
+    while (!mEntries.empty())
+    {
+        release_t release = std::move(mEntries.front().release);
+        mEntries.pop_front();
+        release();
+    }
+}
+
+}
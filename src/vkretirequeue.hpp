@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cinttypes>
+
+#include <deque>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <optional>
+#include <functional>
+#include <type_traits>
+
+namespace blk
+{
+    // Deferred release of device objects which may still be used by in-flight frames (e.g. swapchain recreation)
+    //  Objects retired while frame N is the latest frame are released once frame N is known to be complete
+    struct RetireQueue
+    {
+        using release_t = std::function<void()>;
+
+        struct Entry
+        {
+            std::uint64_t serial;
+            release_t     release;
+        };
+
+        RetireQueue() = default;
+        // NOTE Device must be idle
+        ~RetireQueue();
+
+        RetireQueue(const RetireQueue& rhs) = delete;
+        RetireQueue& operator=(const RetireQueue& rhs) = delete;
+
+        void retire(release_t release);
+
+        // Objects are moved in, and released by their destructor in argument order
+        template<typename... Objects>
+        void retire_objects(Objects&&... objects)
+        {
+            static_assert((!std::is_lvalue_reference_v<Objects> && ...), "objects must be moved in");
+            auto holders = std::make_shared<std::tuple<std::optional<std::decay_t<Objects>>...>>(std::move(objects)...);
+            retire([holders]{
+                std::apply([](auto&... holder) { (holder.reset(), ...); }, *holders);
+            });
+        }
+
+        // A new frame starts, frames up to completed (included) no longer use any object
+        void begin_frame(std::uint64_t completed);
+
+        // NOTE Device must be idle
+        void flush();
+
+        // Latest frame
+        std::uint64_t     mSerial = 0;
+        std::deque<Entry> mEntries;
+    };
+}
@@ -0,0 +1,171 @@
+#include "./vkstartupprofiler.hpp"
+
+#include "./vkprofiler.hpp"
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <mutex>
+#include <thread>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iomanip>
+#include <ostream>
+
+#include <json.hpp>
+
+namespace
+{
+    // Phases begun and not ended yet on the calling thread, see StartupProfiler::Phase::depth
+    thread_local std::uint32_t tDepth = 0;
+
+    double milliseconds(std::uint64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / 1e6;
+    }
+}
+
+namespace blk
+{
+
+StartupProfiler& StartupProfiler::instance()
+{
+    static StartupProfiler sProfiler;
+    return sProfiler;
+}
+
+void StartupProfiler::start(std::uint64_t process_age)
+{
+    std::lock_guard lock(mMutex);
+    mMainThread = std::this_thread::get_id();
+    mProcessAge = process_age;
+    mStart      = profiler::now();
+}
+
+std::size_t StartupProfiler::begin(const char* name)
+{
+    const std::uint64_t begin = profiler::now();
+
+    std::lock_guard lock(mMutex);
+    // NOTE Not started, e.g. the headless benchmark, or already finished
+    if ((mStart == 0) || mFinished)
+        return kNone;
+
+    mPhases.push_back(Phase{
+        .name  = name,
+        .begin = begin,
+        .end   = 0,
+        .depth = tDepth++,
+        .main  = (std::this_thread::get_id() == mMainThread),
+    });
+    return mPhases.size() - 1;
+}
+
+void StartupProfiler::end(std::size_t index)
+{
+    if (index == kNone)
+        return;
+
+    const std::uint64_t end = profiler::now();
+    --tDepth;
+
+    std::lock_guard lock(mMutex);
+    Phase& phase = mPhases[index];
+    if (!mFinished)
+        phase.end = end;
+
+    if constexpr (profiler::kEnabled)
+    {
+        // NOTE Also visible in the Chrome trace, nested into the zones of the calling thread
+        profiler::Ring& ring = profiler::Profiler::instance().ring();
+        ring.push(profiler::Zone{
+            .name  = phase.name,
+            .begin = phase.begin,
+            .end   = end,
+            .depth = ring.mDepth,
+        });
+    }
+}
+
+void StartupProfiler::finish()
+{
+    std::lock_guard lock(mMutex);
+    if (mFinished)
+        return;
+
+    mFinish   = profiler::now();
+    mFinished = true;
+}
+
+bool StartupProfiler::finished() const
+{
+    std::lock_guard lock(mMutex);
+    return mFinished;
+}
+
+void StartupProfiler::report(std::ostream& stream) const
+{
+    std::lock_guard lock(mMutex);
+    const std::uint64_t finish = mFinished ? mFinish : profiler::now();
+
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+    stream << std::fixed << std::setprecision(3);
+
+    stream << "Startup: " << milliseconds(finish - mStart) << " ms";
+    if (mProcessAge > 0)
+        stream << " (+" << milliseconds(mProcessAge) << " ms before main)";
+    stream << '\n';
+
+    for (bool main : { true, false })
+    {
+        bool any = false;
+        for (auto&& phase : mPhases)
+        {
+            if (phase.main != main)
+                continue;
+
+            if (!std::exchange(any, true) && !main)
+                stream << "  Worker threads\n";
+
+            const std::uint64_t end = (phase.end != 0) ? phase.end : finish;
+            stream << std::string(2 * (phase.depth + (main ? 1 : 2)), ' ')
+                   << std::setw(10) << milliseconds(end - phase.begin) << " ms  "
+                   << phase.name
+                   << " @ " << milliseconds(phase.begin - mStart) << " ms"
+                   << ((phase.end != 0) ? "" : " (running)") << '\n';
+        }
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+    stream << std::flush;
+}
+
+void StartupProfiler::export_json(std::ostream& stream) const
+{
+    std::lock_guard lock(mMutex);
+    const std::uint64_t finish = mFinished ? mFinish : profiler::now();
+
+    stream << "{\n";
+    stream << "  \"total_ms\": " << milliseconds(finish - mStart) << ",\n";
+    stream << "  \"process_age_ms\": " << milliseconds(mProcessAge) << ",\n";
+    stream << "  \"phases\": [";
+    for (std::size_t idx = 0; idx < mPhases.size(); ++idx)
+    {
+        const Phase& phase = mPhases[idx];
+        const std::uint64_t end = (phase.end != 0) ? phase.end : finish;
+        stream << ((idx == 0) ? "\n" : ",\n")
+               << "    { \"name\": " << json_string(phase.name)
+               << ", \"depth\": " << phase.depth
+               << ", \"thread\": \"" << (phase.main ? "main" : "worker") << "\""
+               << ", \"begin_ms\": " << milliseconds(phase.begin - mStart)
+               << ", \"duration_ms\": " << milliseconds(end - phase.begin)
+               << ", \"running\": " << ((phase.end != 0) ? "false" : "true")
+               << " }";
+    }
+    stream << "\n  ]\n}\n" << std::flush;
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cinttypes>
+
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <ostream>
+
+namespace blk
+{
+    // Phases from process start to the first presented frame, e.g. instance, device, swapchain and pipelines creation
+    //  NOTE Phases may begin on any thread (e.g. pipeline compilation), those begun after finish are ignored
+    //  NOTE Names must outlive the profiler, i.e. string literals
+    struct StartupProfiler
+    {
+        static constexpr std::size_t kNone = std::numeric_limits<std::size_t>::max();
+
+        struct Phase
+        {
+            const char*   name;
+            // blk::profiler::now clock, in nanoseconds
+            std::uint64_t begin;
+            // 0 while running
+            std::uint64_t end;
+            // Enclosing phases count on the same thread
+            std::uint32_t depth;
+            // Thread which called start, i.e. the main thread
+            bool          main;
+        };
+
+        static StartupProfiler& instance();
+
+        // Origin of the report, process_age is the time spent before (e.g. loader, static initialization)
+        void start(std::uint64_t process_age = 0);
+        // Index to end the phase with, kNone once finished
+        [[nodiscard]] std::size_t begin(const char* name);
+        void end(std::size_t index);
+        // Freeze the report, phases still running are reported as such
+        void finish();
+        [[nodiscard]] bool finished() const;
+
+        // Indented tree of phases, main thread first, in milliseconds
+        void report(std::ostream& stream) const;
+        // { "total_ms", "process_age_ms", "phases": [{ "name", "depth", "thread", "begin_ms", "duration_ms", "running" }] }
+        void export_json(std::ostream& stream) const;
+
+        mutable std::mutex mMutex;
+        std::vector<Phase> mPhases;
+        std::thread::id    mMainThread;
+        std::uint64_t      mProcessAge = 0;
+        std::uint64_t      mStart      = 0;
+        std::uint64_t      mFinish     = 0;
+        bool               mFinished   = false;
+    };
+
+    // Phase spanning the enclosing scope
+    struct StartupPhase
+    {
+        explicit StartupPhase(const char* name)
+            : mIndex(StartupProfiler::instance().begin(name))
+        {
+        }
+
+        ~StartupPhase()
+        {
+            StartupProfiler::instance().end(mIndex);
+        }
+
+        StartupPhase(const StartupPhase& rhs) = delete;
+        StartupPhase& operator=(const StartupPhase& rhs) = delete;
+
+        std::size_t mIndex;
+    };
+}
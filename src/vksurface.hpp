@@ -8,6 +8,9 @@ namespace blk
     {
         #ifdef OS_WINDOWS
         using info_t = VkWin32SurfaceCreateInfoKHR;
+        #else
+        // NOTE Only for the code shared with offscreen tools to build, e.g. benchmarks
+        using info_t = VkHeadlessSurfaceCreateInfoEXT;
         #endif
 
         explicit Surface(VkInstance instance, VkSurfaceKHR surface, const info_t& info)
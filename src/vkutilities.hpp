@@ -14,6 +14,7 @@
 #include <algorithm>
 
 #include "./vkdebug.hpp"
+#include "./vkdebugutils.hpp"
 
 #define STRING2(x) #x
 #define STRING(x) STRING2(x)
@@ -121,8 +122,29 @@ constexpr std::uint32_t next_pow2_cpp20(std::uint32_t v)
 }
 #endif
 
+// Extent-sized resources are allocated to rounded-up extents, so that small resizes can re-use them
+constexpr std::uint32_t kExtentBucketGranularity = 256;
+
+inline
+constexpr VkExtent2D bucket_extent(const VkExtent2D& extent, std::uint32_t granularity = kExtentBucketGranularity)
+{
+    auto round_up = [granularity](std::uint32_t v) {
+        return ((std::max(v, 1u) + granularity - 1) / granularity) * granularity;
+    };
+    return VkExtent2D{
+        .width  = round_up(extent.width),
+        .height = round_up(extent.height),
+    };
+}
+
+inline
+constexpr bool same_extent(const VkExtent2D& lhs, const VkExtent2D& rhs)
+{
+    return (lhs.width == rhs.width) && (lhs.height == rhs.height);
+}
+
 inline
-bool has_extension(const std::span<VkExtensionProperties>& extensions, const std::string_view& extension)
+bool has_extension(const std::span<const VkExtensionProperties>& extensions, const std::string_view& extension)
 {
     return std::find_if(
         std::begin(extensions), std::end(extensions),
@@ -219,7 +241,21 @@ const char* DeviceType2Text(const VkPhysicalDeviceType& type)
 
 [[nodiscard]]
 inline
-VkCommandBuffer create_command_buffer(VkDevice vkdevice, VkCommandPool vkcmdpool, VkCommandBufferLevel level)
+const char* PresentMode2Text(const VkPresentModeKHR& mode)
+{
+    switch(mode)
+    {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR   : return "IMMEDIATE";
+        case VK_PRESENT_MODE_MAILBOX_KHR     : return "MAILBOX";
+        case VK_PRESENT_MODE_FIFO_KHR        : return "FIFO";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED";
+        default                              : return "Unknown";
+    }
+}
+
+[[nodiscard]]
+inline
+VkCommandBuffer create_command_buffer(VkDevice vkdevice, VkCommandPool vkcmdpool, VkCommandBufferLevel level, const char* name = nullptr)
 {
     VkCommandBuffer vkcmdbuffer;
     const VkCommandBufferAllocateInfo info{
@@ -230,6 +266,7 @@ VkCommandBuffer create_command_buffer(VkDevice vkdevice, VkCommandPool vkcmdpool
         .commandBufferCount = 1,
     };
     CHECK(vkAllocateCommandBuffers(vkdevice, &info, &vkcmdbuffer));
+    blk::debug::name(vkdevice, vkcmdbuffer, name);
     return vkcmdbuffer;
 }
 
@@ -8,11 +8,19 @@
 #include <limits>
 #include <chrono>
 #include <thread>
+#include <fstream>
+#include <exception>
 
 #include <map>
+#include <span>
+#include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <optional>
+#include <utility>
+#include <algorithm>
 
 #include <locale>
 #include <codecvt>
@@ -29,11 +37,18 @@
 #include "./vksurface.hpp"
 #include "./vkapplication.hpp"
 #include "./vkpresentation.hpp"
+#include "./vkframepacer.hpp"
+#include "./vklatencycontroller.hpp"
 #include "./vkphysicaldevice.hpp"
+#include "./vkprofiler.hpp"
+#include "./vkperformancewarnings.hpp"
+#include "./vkmemorytracer.hpp"
+#include "./vkstartupprofiler.hpp"
 
 #include "./vkpass.hpp"
 
 #include "./sample0/vksample0.hpp"
+#include "./sample0/uiinputcapture.hpp"
 
 namespace
 {
@@ -44,12 +59,165 @@ namespace
     {
         blk::Engine& engine;
         blk::Presentation& presentation;
+        blk::FramePacer& pacer;
+        blk::LatencyController& latency;
         blk::sample0::Sample& sample;
         bool& ready;
         bool& shutting_down;
         bool& resizing;
+        // Latest WM_SIZE resolution, coalesced and applied once per frame
+        std::optional<VkExtent2D> pending_resolution = std::nullopt;
+        // Ended once the first frame is presented, see blk::StartupProfiler
+        std::size_t startup_phase = blk::StartupProfiler::kNone;
     };
 
+    // NOTE Replaced objects are retired, the latest frame may still be in flight
+    void on_swapchain_recreated(WindowUserData& userdata, const VkExtent2D& new_resolution)
+    {
+        blk::Presentation& presentation = userdata.presentation;
+        blk::sample0::Sample& sample = userdata.sample;
+
+        if (std::memcmp(&(sample.mResolution), &(new_resolution), sizeof(new_resolution)) != 0)
+        {
+            sample.onResize(new_resolution);
+        }
+
+        sample.recreate_backbuffers(presentation.mColorFormat, presentation.mImageUsage, presentation.mImages);
+        sample.mPassUIOverlay.mUI.present_mode = presentation.mPresentMode;
+        userdata.pacer.onSwapchainRecreated();
+        userdata.latency.onSwapchainRecreated();
+    }
+
+    // Apply the latest resize event received since the previous frame, if any
+    void apply_pending_resize(WindowUserData& userdata)
+    {
+        if (auto resolution = std::exchange(userdata.pending_resolution, std::nullopt))
+        {
+            // NOTE Resources in use by the latest frame are retired, not destroyed
+            userdata.presentation.onResize(*resolution);
+            on_swapchain_recreated(userdata, userdata.presentation.mResolution);
+        }
+    }
+
+    // Dispatch input received while waiting, so that the frame samples the latest state
+    void pump_input_messages()
+    {
+        MSG msg = { };
+        while (PeekMessage(&msg, nullptr, WM_KEYFIRST, WM_KEYLAST, PM_REMOVE)
+            || PeekMessage(&msg, nullptr, WM_MOUSEFIRST, WM_MOUSELAST, PM_REMOVE))
+        {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+    }
+
+    // Wait for the previous frame, then until the latest safe moment to start the new one
+    //  NOTE To call before sampling input, i.e. Sample::onIdle
+    void begin_frame(WindowUserData& userdata)
+    {
+        blk::FramePacer& pacer = userdata.pacer;
+        blk::LatencyController& latency = userdata.latency;
+        blk::sample0::Sample& sample = userdata.sample;
+
+        auto& ui = sample.mPassUIOverlay.mUI;
+
+        // NOTE Previous frame zones are complete, see PassUIOverlay::render_profiler_window
+        BLK_PROFILE_FRAME();
+        BLK_PROFILE_ZONE("begin_frame");
+        blk::PerformanceWarnings::instance().begin_frame();
+        blk::MemoryTracer::instance().begin_frame();
+
+        {// Settings
+            latency.mEnabled = ui.jit_frame_start;
+            // NOTE Display deadline is only known when nothing is queued for display
+            pacer.set_max_queued_presents(ui.jit_frame_start ? 0 : blk::FramePacer::kMaxQueuedPresents);
+            pacer.set_target_interval(blk::FramePacer::duration_t(ui.target_frame_interval));
+        }
+
+        apply_pending_resize(userdata);
+
+        // NOTE Previous frame submission is complete, its resources (e.g. surface indexed VkCommandBuffer, UI buffers) can be re-used
+        pacer.begin_frame();
+        latency.wait_frame_start(pacer);
+        pump_input_messages();
+
+        // NOTE Frame waiting on the font upload is complete
+        sample.mPassUIOverlay.poll_font_image_upload();
+
+        {// Statistics
+            const blk::FramePacer::Statistics pacing = pacer.statistics();
+            ui.pacing_present_wait = pacer.uses_present_wait();
+            ui.pacing_mean         = pacing.mean;
+            ui.pacing_jitter       = pacing.jitter;
+            ui.pacing_min          = pacing.min;
+            ui.pacing_max          = pacing.max;
+
+            const blk::LatencyController::Statistics latencies = latency.statistics();
+            ui.latency_measured    = latencies.measured;
+            ui.latency             = latencies.latency;
+            ui.latency_cpu         = latencies.cpu;
+            ui.latency_gpu         = latencies.gpu;
+            ui.latency_sleep       = latencies.sleep;
+        }
+    }
+
+    // Acquire, record, submit and present a single frame, recreating the swapchain when it is no longer adequate
+    //  NOTE To call after begin_frame
+    void render_frame(WindowUserData& userdata)
+    {
+        blk::Presentation& presentation = userdata.presentation;
+        blk::FramePacer& pacer = userdata.pacer;
+        blk::LatencyController& latency = userdata.latency;
+        blk::sample0::Sample& sample = userdata.sample;
+
+        const blk::Queue* presentation_queue = presentation.mPresentationQueues.at(0);
+
+        BLK_PROFILE_ZONE("render_frame");
+        blk::Presentation::Image presentation_image = presentation.acquire_next(kTimeoutAcquirePresentationImage);
+        sample.record(presentation_image.index, presentation_image.commandbuffer);
+
+        VkSemaphore render_semaphore = sample.mRenderSemaphores.at(presentation_image.index);
+
+        std::vector<VkSemaphore>          wait_semaphores{ presentation_image.semaphore };
+        std::vector<VkPipelineStageFlags> wait_stages{ presentation_image.destination_stage_mask };
+        // NOTE Font upload overlaps with startup, only the first frame waits for it
+        if (VkSemaphore font_semaphore = sample.mPassUIOverlay.consume_font_image_semaphore(); font_semaphore != VK_NULL_HANDLE)
+        {
+            wait_semaphores.push_back(font_semaphore);
+            wait_stages.push_back(VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        }
+
+        // TODO Figure out how we can use different queue for sample computations and presentation job
+        //  This probably means that we need to record computations with commandbuffers than ones from presentation
+        blk::Engine::submit(
+            *presentation_queue,
+            std::span<const VkCommandBuffer>(&(presentation_image.commandbuffer), 1),
+            wait_semaphores,
+            wait_stages,
+            std::span<const VkSemaphore>(&render_semaphore, 1),
+            pacer.fence()
+        );
+        latency.submitted();
+
+        const std::uint64_t present_id = pacer.present_id();
+        auto result_present = presentation.present(presentation_image, render_semaphore, present_id);
+        pacer.end_frame();
+        latency.presented(pacer, present_id);
+
+        if (userdata.startup_phase != blk::StartupProfiler::kNone)
+        {
+            // NOTE Presentation request returned, the image may not be on screen yet
+            blk::StartupProfiler& startup = blk::StartupProfiler::instance();
+            startup.end(std::exchange(userdata.startup_phase, blk::StartupProfiler::kNone));
+            startup.finish();
+        }
+
+        if ((result_present == VK_SUBOPTIMAL_KHR) || (result_present == VK_ERROR_OUT_OF_DATE_KHR))
+        {
+            on_swapchain_recreated(userdata, presentation.recreate_swapchain());
+        }
+    }
+
     // cf. https://stackoverflow.com/questions/215963/how-do-you-properly-use-widechartomultibyte
 
     // Convert a wide Unicode string to an UTF8 string
@@ -67,6 +235,22 @@ namespace
         #endif
     }
 
+    // Time elapsed since the process creation, i.e. spent before reaching wWinMain (e.g. loader, static initialization)
+    std::uint64_t process_age()
+    {
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+            return 0;
+
+        FILETIME now;
+        GetSystemTimePreciseAsFileTime(&now);
+
+        // NOTE FILETIME are 100 nanoseconds intervals
+        const std::uint64_t begin = (static_cast<std::uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+        const std::uint64_t end   = (static_cast<std::uint64_t>(now.dwHighDateTime) << 32) | now.dwLowDateTime;
+        return (end > begin) ? (end - begin) * 100 : 0;
+    }
+
     // Convert an UTF8 string to a wide Unicode String
     std::wstring utf8_decode(const std::string &str)
     {
@@ -151,6 +335,24 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 
     ConsoleHolder console_holder;
 
+    BLK_PROFILE_THREAD("Main");
+
+    // NOTE Started before anything else, see blk::StartupProfiler::report
+    blk::StartupProfiler& startup = blk::StartupProfiler::instance();
+    startup.start(process_age());
+
+    // --startup-only, quit once the first frame is presented, e.g. to measure cold and warm start
+    const bool startup_only = std::ranges::find(args, std::string_view("--startup-only")) != std::end(args);
+    std::optional<std::string> startup_report_path;
+    {// --startup-report=<path>
+        constexpr std::string_view kStartupReportOption = "--startup-report=";
+        for (auto&& arg : args)
+        {
+            if (arg.starts_with(kStartupReportOption))
+                startup_report_path = arg.substr(kStartupReportOption.size());
+        }
+    }
+
     std::cout << "_MSC_VER        : " << _MSC_VER << std::endl;
     std::cout << "_MSC_FULL_VER   : " << _MSC_FULL_VER << std::endl;
     std::cout << "_MSC_BUILD      : " << _MSC_BUILD << std::endl;
@@ -163,17 +365,24 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 
     // Application - Instance
 
+    std::size_t startup_phase = startup.begin("Instance");
+
     std::uint32_t apiVersion;
     CHECK(vkEnumerateInstanceVersion(&apiVersion));
     // This playground is to experiment with Vulkan 1.2
     assert(apiVersion >= VK_MAKE_VERSION(1,2,0));
 
-    VulkanApplication application(Version{ VK_MAKE_VERSION(1, 2, 0) });
+    // --best-practices, see blk::PerformanceWarnings
+    const bool best_practices = std::ranges::find(args, std::string_view("--best-practices")) != std::end(args);
+    VulkanApplication application(Version{ VK_MAKE_VERSION(1, 2, 0) }, true, best_practices);
+
+    startup.end(startup_phase);
 
     assert(has_extension(application.mExtensions, VK_KHR_WIN32_SURFACE_EXTENSION_NAME));
 
     HWND hWindow;
     {// Window
+        const blk::StartupPhase phase("Window");
         WNDCLASSEX clazz{
             .cbSize        = sizeof(WNDCLASSEX),
             .style         = CS_HREDRAW | CS_VREDRAW,
@@ -221,6 +430,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
         assert(hWindow);
     }
 
+    startup_phase = startup.begin("Surface");
     blk::Surface vksurface = blk::Surface::create(
         application, VkWin32SurfaceCreateInfoKHR{
             .sType     = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR,
@@ -231,6 +441,9 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
         }
     );
 
+    startup.end(startup_phase);
+
+    startup_phase = startup.begin("Physical Devices");
     auto vkphysicaldevices = blk::physicaldevices(application);
     assert(vkphysicaldevices.size() > 0);
 
@@ -279,7 +492,10 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 
     std::cout << "Selected GPU: " << vkphysicaldevice.mProperties.deviceName << std::endl;
 
+    startup.end(startup_phase);
+
     blk::Engine engine = [&application, &vkphysicaldevice]{
+        const blk::StartupPhase phase("Engine");
         std::uint32_t priorities_count = 0;
         for (auto&& queue_family : vkphysicaldevice.mQueueFamilies)
             priorities_count = std::max(priorities_count, queue_family.mProperties.queueCount);
@@ -299,14 +515,59 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
         return blk::Engine(application, vkphysicaldevice, info_queues);
     }();
 
-    blk::Presentation presentation(engine, vksurface, kResolution);
+    blk::PresentPolicy present_policy = blk::PresentPolicy::PowerSaving;
+    {// --present-mode=<low-latency|throughput|power-saving>
+        constexpr std::string_view kPresentModeOption = "--present-mode=";
+        for (auto&& arg : args)
+        {
+            if (!arg.starts_with(kPresentModeOption))
+                continue;
+
+            if (auto policy = blk::parse_present_policy(std::string_view(arg).substr(kPresentModeOption.size())))
+                present_policy = *policy;
+            else
+                std::cerr << "Unknown present mode: " << arg << std::endl;
+        }
+    }
 
-    blk::sample0::Sample sample(engine, presentation.mColorFormat, presentation.mImages, kResolution);
+    startup_phase = startup.begin("Presentation");
+    blk::Presentation presentation(engine, vksurface, kResolution, present_policy);
+    startup.end(startup_phase);
+
+    float target_frame_interval = 0.0f;
+    {// --frame-interval=<milliseconds>
+        constexpr std::string_view kFrameIntervalOption = "--frame-interval=";
+        for (auto&& arg : args)
+        {
+            if (!arg.starts_with(kFrameIntervalOption))
+                continue;
+
+            try
+            {
+                target_frame_interval = std::max(0.0f, std::stof(arg.substr(kFrameIntervalOption.size())));
+            }
+            catch (const std::exception&)
+            {
+                std::cerr << "Invalid frame interval: " << arg << std::endl;
+            }
+        }
+    }
+
+    blk::FramePacer pacer(engine, presentation);
+
+    blk::LatencyController latency;
+    {// --jit-frame-start
+        latency.mEnabled = std::ranges::find(args, std::string("--jit-frame-start")) != std::ranges::end(args);
+    }
+
+    startup_phase = startup.begin("Sample");
+    blk::sample0::Sample sample(engine, presentation.mColorFormat, presentation.mImageUsage, presentation.mImages, kResolution);
+    startup.end(startup_phase);
 
     bool ready = false;
     bool shutting_down = false;
     bool resizing = false;
-    WindowUserData user_data{engine, presentation, sample, ready, shutting_down, resizing};
+    WindowUserData user_data{engine, presentation, pacer, latency, sample, ready, shutting_down, resizing};
 
     ShowWindow(hWindow, nCmdShow);
     SetForegroundWindow(hWindow);
@@ -318,25 +579,66 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
     auto& passui = sample.mPassUIOverlay;
     auto& passscene = sample.mPassScene;
 
-    {// Font Image
-        const blk::Queue* queue = passui.mGraphicsQueue;
-
-        engine.submit(
-            *passui.mGraphicsQueue,
-            { passui.mFontImageStagingCommandBuffer },
-            { },
-            { },
-            { passui.mFontImageStagingSemaphore },
-            passui.mFontImageStagingFence);
+    passui.mUI.present_policy = presentation.mPresentPolicy;
+    passui.mUI.present_mode   = presentation.mPresentMode;
+    passui.mUI.target_frame_interval = target_frame_interval;
+    passui.mUI.jit_frame_start       = latency.mEnabled;
 
-        // TODO Do not block on that fence, inject the font image update semaphore into later queue submission for synchronization
-        vkWaitForFences(engine.mDevice, 1, &(passui.mFontImageStagingFence), VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+    {// --record-input=<path>
+        constexpr std::string_view kRecordInputOption = "--record-input=";
+        for (auto&& arg : args)
+        {
+            if (arg.starts_with(kRecordInputOption))
+                passui.mInputRecorder = std::make_unique<blk::sample0::InputRecorder>(arg.substr(kRecordInputOption.size()), sample.mResolution);
+        }
+    }
+    {// --replay-input=<path> [--fixed-timestep=<milliseconds>]
+        //  NOTE Every recorded frame is rendered, then the application quits, e.g. to compare builds on identical workloads
+        constexpr std::string_view kReplayInputOption  = "--replay-input=";
+        constexpr std::string_view kFixedTimestepOption = "--fixed-timestep=";
+        for (auto&& arg : args)
+        {
+            if (arg.starts_with(kReplayInputOption))
+            {
+                auto replay = std::make_unique<blk::sample0::InputReplay>(arg.substr(kReplayInputOption.size()));
+                if (!replay->valid())
+                {
+                    std::cerr << "Invalid input recording: " << arg << std::endl;
+                    continue;
+                }
+                if (!same_extent(replay->mResolution, sample.mResolution))
+                    std::cerr << "Input recorded at " << replay->mResolution.width << 'x' << replay->mResolution.height << ", replayed at another resolution" << std::endl;
 
-        passui.clear_font_image_transient_data();
+                passui.mInputReplay = std::move(replay);
+                passui.mUI.render_on_demand = false;
+            }
+            else if (arg.starts_with(kFixedTimestepOption))
+            {
+                try
+                {
+                    passui.mFixedTimestep = blk::sample0::PassUIOverlay::frame_time_delta_ms_t(std::max(0.0f, std::stof(arg.substr(kFixedTimestepOption.size()))));
+                }
+                catch (const std::exception&)
+                {
+                    std::cerr << "Invalid fixed timestep: " << arg << std::endl;
+                }
+            }
+        }
     }
 
+    std::cout << "Present Mode: " << PresentMode2Text(presentation.mPresentMode) << " (" << blk::PresentPolicy2Text(presentation.mPresentPolicy) << ')' << std::endl;
+    std::cout << "Frame Pacing: " << (pacer.uses_present_wait() ? "present wait" : "fence") << std::endl;
+
+    // NOTE Not waited here, see render_frame
+    passui.submit_font_image_upload();
+
     ready = true;
-    const blk::Queue* presentation_queue = presentation.mPresentationQueues.at(0);
+
+    // NOTE Pipelines still compiling are drawn once ready, they are reported as worker phases
+    user_data.startup_phase = startup.begin("First Frame");
+    bool startup_reported = false;
+
+    const auto replay_start = std::chrono::steady_clock::now();
 
     MSG msg = { };
     while (msg.message != WM_QUIT)
@@ -347,47 +649,54 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
             DispatchMessage(&msg);
         }
 
-        if (ready)
-            sample.onIdle();
-        
-            if (!shutting_down)
+        // NOTE First frame may also be rendered by WM_PAINT, see render_frame
+        if (!startup_reported && startup.finished())
+        {
+            startup_reported = true;
+            startup.report(std::cout);
+            if (startup_report_path)
             {
-                if(!IsIconic(hWindow))
-                {
-                    blk::Presentation::Image presentation_image = presentation.acquire_next(kTimeoutAcquirePresentationImage);
-                    sample.record(presentation_image.index, presentation_image.commandbuffer);
-
-                    VkSemaphore render_semaphore = sample.mRenderSemaphores.at(presentation_image.index);
-
-                    // TODO Figure out how we can use different queue for sample computations and presentation job
-                    //  This probably means that we need to record computations with commandbuffers than ones from presentation
-                    engine.submit(
-                        *presentation_queue,
-                        { presentation_image.commandbuffer },
-                        { presentation_image.semaphore },
-                        { presentation_image.destination_stage_mask },
-                        { render_semaphore }
-                    );
-
-                    auto result_present = presentation.present(presentation_image, render_semaphore);
-                    // NOTE We block to avoid override something in use (e.g. surface indexed VkCommandBuffer)
-                    // TODO Block per command buffer, instead of a global lock for all of them
-                    CHECK(vkQueueWaitIdle(*presentation_queue));
-
-                    if ((result_present == VK_SUBOPTIMAL_KHR) || (result_present == VK_ERROR_OUT_OF_DATE_KHR))
-                    {
-                        vkDeviceWaitIdle(engine.mDevice);
-                        auto new_resolution = presentation.recreate_swapchain();
-
-                        if (std::memcmp(&(sample.mResolution), &(new_resolution), sizeof(new_resolution)) != 0)
-                        {
-                            sample.onResize(new_resolution);
-                        }
-
-                        sample.recreate_backbuffers(presentation.mColorFormat, presentation.mImages);
-                    }
-                }
+                std::ofstream stream(*startup_report_path);
+                if (stream)
+                    startup.export_json(stream);
+                else
+                    std::cerr << "Cannot write startup report: " << *startup_report_path << std::endl;
+            }
+            if (startup_only)
+                PostQuitMessage(0);
+        }
+
+        if (shutting_down || IsIconic(hWindow))
+            continue;
+
+        if (std::exchange(passui.mUI.present_policy_changed, false))
+        {
+            on_swapchain_recreated(user_data, presentation.set_present_policy(passui.mUI.present_policy));
+            std::cout << "Present Mode: " << PresentMode2Text(presentation.mPresentMode) << " (" << blk::PresentPolicy2Text(presentation.mPresentPolicy) << ')' << std::endl;
+        }
+
+        // NOTE Input is sampled as late as possible, once pacing waits are over
+        if ((ready && (sample.need_frame() || user_data.pending_resolution)) || !passui.mUI.render_on_demand)
+        {
+            // NOTE UI draw data are uploaded into buffers the previous frame may still read from
+            begin_frame(user_data);
+            if (ready)
+                sample.onIdle();
+            render_frame(user_data);
+
+            if (passui.mInputReplay && passui.mInputReplay->finished())
+            {
+                const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - replay_start;
+                std::cout << "Input Replay: " << passui.mInputReplay->mFrames.size() << " frames in " << elapsed.count() << " ms" << std::endl;
+                passui.mInputReplay.reset();
+                PostQuitMessage(0);
             }
+        }
+        else
+        {
+            // NOTE Nothing to render, sleep until any input is available (even if already peeked)
+            MsgWaitForMultipleObjectsEx(0, nullptr, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        }
     }
 
     vkDeviceWaitIdle(engine.mDevice);
@@ -449,46 +758,16 @@ LRESULT CALLBACK MainWindowProcedure(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM
     case WM_PAINT:
         {
             // NOTE To make UI pass aware of resize changes
+            begin_frame(*userdata);
             sample.onIdle();
 
-            blk::Presentation::Image presentation_image = presentation.acquire_next(kTimeoutAcquirePresentationImage);
-            sample.record(presentation_image.index, presentation_image.commandbuffer);
-
-            VkSemaphore render_semaphore = sample.mRenderSemaphores.at(presentation_image.index);
-
-            // TODO Figure out how we can use different queue for sample computations and presentation job
-            //  This probably means that we need to record computations with commandbuffers than ones from presentation
-            const blk::Queue* presentation_queue = presentation.mPresentationQueues.at(0);
-            engine.submit(
-                *presentation_queue,
-                { presentation_image.commandbuffer },
-                { presentation_image.semaphore },
-                { presentation_image.destination_stage_mask },
-                { render_semaphore }
-            );
-
-            auto result_present = presentation.present(presentation_image, render_semaphore);
-            // NOTE We block to avoid override something in use (e.g. surface indexed VkCommandBuffer)
-            // TODO Block per command buffer, instead of a global lock for all of them
-            CHECK(vkQueueWaitIdle(*presentation_queue));
-
-            if ((result_present == VK_SUBOPTIMAL_KHR) || (result_present == VK_ERROR_OUT_OF_DATE_KHR))
-            {
-                vkDeviceWaitIdle(engine.mDevice);
-                auto new_resolution = presentation.recreate_swapchain();
-
-                if (std::memcmp(&(sample.mResolution), &(new_resolution), sizeof(new_resolution)) != 0)
-                {
-                    sample.onResize(new_resolution);
-                }
-
-                sample.recreate_backbuffers(presentation.mColorFormat, presentation.mImages);
-            }
+            render_frame(*userdata);
 
             ValidateRect(hWnd, NULL);
             return 0;
         }
     case WM_KEYDOWN:
+        passui.invalidate();
         switch (wParam)
         {
     //     case KEY_P:
@@ -580,6 +859,10 @@ LRESULT CALLBACK MainWindowProcedure(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM
         passui.mMouse.offset.y = static_cast<float>(HIWORD(lParam));
         break;
     }
+    case WM_KEYUP:
+    case WM_CHAR:
+        passui.invalidate();
+        return MinimalWindowProcedure(hWnd, uMsg, wParam, lParam);
     case WM_SIZE:
         switch(wParam)
         {
@@ -588,15 +871,8 @@ LRESULT CALLBACK MainWindowProcedure(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM
                     return MinimalWindowProcedure(hWnd, uMsg, wParam, lParam);
             case SIZE_MAXIMIZED:
                 {
-                    VkExtent2D new_resolution{.width  = LOWORD(lParam), .height = HIWORD(lParam)};
-
-                    // Ensure all operations on the device have been finished before destroying resources
-                    vkDeviceWaitIdle(engine.mDevice);
-
-                    presentation.onResize(new_resolution);
-
-                    sample.onResize(presentation.mResolution);
-                    sample.recreate_backbuffers(presentation.mColorFormat, presentation.mImages);
+                    // NOTE Dragging emits a storm of events, only the latest one is applied by the next frame
+                    userdata->pending_resolution = VkExtent2D{.width  = LOWORD(lParam), .height = HIWORD(lParam)};
                     return 0;
                 }
             case SIZE_MINIMIZED:
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   include <emmintrin.h>
+#   define BLK_HASH_SSE2
+#endif
+
+// Non-cryptographic 64-bit content hash, meant to detect changes in large buffers (e.g. vertex data)
+//  Input is consumed by 32-bytes stripes, accumulated into 4 x 64-bit lanes, following XXH3 long input structure:
+//  - each stripe of a block is keyed by the secret at its own offset, and by its index in the input
+//  - lanes are scrambled after every block, so that the order of blocks matters too
+//  SIMD and scalar implementations produce the same hash for the same input
+//  NOTE Same structure, not the same values as XXH3
+
+namespace detail::hash
+{
+    constexpr std::size_t kStripeSize      = 32;
+    constexpr std::size_t kStripesPerBlock = 16;
+    // Stripe n of a block is keyed by words [n, n + 4), the last 4 words scramble the lanes
+    constexpr std::size_t kSecretWords     = kStripesPerBlock + 3;
+
+    constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    // NOTE 32-bit, SSE2/AVX2 only multiply 32-bit lanes
+    constexpr std::uint64_t kPrime32 = 0x9E3779B1ULL;
+
+    struct Secret
+    {
+        std::uint64_t words[kSecretWords];
+    };
+
+    // splitmix64 sequence
+    constexpr Secret make_secret(std::uint64_t state)
+    {
+        Secret secret{};
+        for (std::uint64_t& word : secret.words)
+        {
+            state += 0x9E3779B97F4A7C15ULL;
+            std::uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+        return secret;
+    }
+
+    alignas(32) constexpr Secret kSecret = make_secret(0xBE4BA423396CFEB8ULL);
+    constexpr const std::uint64_t* kScrambleSecret = kSecret.words + kSecretWords - 4;
+
+    inline std::uint64_t avalanche(std::uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    inline std::uint64_t finalize(const std::uint64_t (&lanes)[4], std::size_t size)
+    {
+        std::uint64_t h = static_cast<std::uint64_t>(size) * kPrime1;
+        for (std::uint64_t lane : lanes)
+            h = avalanche(h ^ avalanche(lane));
+        return h;
+    }
+
+    // key = data ^ (secret + index), acc += lo32(key) * hi32(key) + data
+    inline void accumulate_scalar(std::uint64_t (&lanes)[4], const std::byte* stripe, const std::uint64_t* secret, std::uint64_t index)
+    {
+        for (std::size_t idx = 0; idx < 4; ++idx)
+        {
+            std::uint64_t data;
+            std::memcpy(&data, stripe + idx * sizeof(std::uint64_t), sizeof(std::uint64_t));
+            const std::uint64_t key = data ^ (secret[idx] + index);
+            lanes[idx] += (key & 0xFFFFFFFFULL) * (key >> 32) + data;
+        }
+    }
+
+    // acc = (acc ^ (acc >> 47) ^ secret) * prime32
+    inline void scramble_scalar(std::uint64_t (&lanes)[4])
+    {
+        for (std::size_t idx = 0; idx < 4; ++idx)
+            lanes[idx] = (lanes[idx] ^ (lanes[idx] >> 47) ^ kScrambleSecret[idx]) * kPrime32;
+    }
+
+    #if defined(__AVX2__)
+    inline __m256i accumulate_avx2(__m256i accumulator, const std::byte* stripe, const std::uint64_t* secret, std::uint64_t index)
+    {
+        const __m256i value   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe));
+        const __m256i keys    = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret)), _mm256_set1_epi64x(static_cast<long long>(index)));
+        const __m256i key     = _mm256_xor_si256(value, keys);
+        const __m256i product = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));
+        return _mm256_add_epi64(accumulator, _mm256_add_epi64(product, value));
+    }
+
+    inline __m256i scramble_avx2(__m256i accumulator)
+    {
+        const __m256i prime = _mm256_set1_epi64x(static_cast<long long>(kPrime32));
+        const __m256i key   = _mm256_xor_si256(
+            _mm256_xor_si256(accumulator, _mm256_srli_epi64(accumulator, 47)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kScrambleSecret))
+        );
+        // NOTE 64-bit by 32-bit multiplication, from two 32-bit ones
+        const __m256i lo = _mm256_mul_epu32(key, prime);
+        const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(key, 32), prime);
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+    }
+    #elif defined(BLK_HASH_SSE2)
+    inline __m128i accumulate_sse2(__m128i accumulator, const std::byte* half, const std::uint64_t* secret, std::uint64_t index)
+    {
+        const __m128i value   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(half));
+        const __m128i keys    = _mm_add_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(secret)), _mm_set1_epi64x(static_cast<long long>(index)));
+        const __m128i key     = _mm_xor_si128(value, keys);
+        const __m128i product = _mm_mul_epu32(key, _mm_srli_epi64(key, 32));
+        return _mm_add_epi64(accumulator, _mm_add_epi64(product, value));
+    }
+
+    inline __m128i scramble_sse2(__m128i accumulator, const std::uint64_t* secret)
+    {
+        const __m128i prime = _mm_set1_epi64x(static_cast<long long>(kPrime32));
+        const __m128i key   = _mm_xor_si128(
+            _mm_xor_si128(accumulator, _mm_srli_epi64(accumulator, 47)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret))
+        );
+        // NOTE 64-bit by 32-bit multiplication, from two 32-bit ones
+        const __m128i lo = _mm_mul_epu32(key, prime);
+        const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(key, 32), prime);
+        return _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+    }
+    #endif
+}
+
+inline std::uint64_t content_hash(const void* data, std::size_t size, std::uint64_t seed = 0)
+{
+    using namespace detail::hash;
+
+    const std::byte* bytes = static_cast<const std::byte*>(data);
+    const std::size_t stripe_count = size / kStripeSize;
+
+    alignas(32) std::uint64_t lanes[4] = {
+        seed + kPrime1, seed + kPrime2, seed - kPrime3, seed ^ kPrime1,
+    };
+
+    {// Stripes
+        #if defined(__AVX2__)
+            __m256i accumulator = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+            for (std::size_t idx = 0; idx < stripe_count; ++idx)
+            {
+                const std::size_t offset = idx % kStripesPerBlock;
+                accumulator = accumulate_avx2(accumulator, bytes + idx * kStripeSize, kSecret.words + offset, idx);
+                if (offset == kStripesPerBlock - 1)
+                    accumulator = scramble_avx2(accumulator);
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+        #elif defined(BLK_HASH_SSE2)
+            __m128i accumulators[2] = {
+                _mm_load_si128(reinterpret_cast<const __m128i*>(lanes + 0)),
+                _mm_load_si128(reinterpret_cast<const __m128i*>(lanes + 2)),
+            };
+            for (std::size_t idx = 0; idx < stripe_count; ++idx)
+            {
+                const std::size_t offset = idx % kStripesPerBlock;
+                for (std::size_t half = 0; half < 2; ++half)
+                {
+                    accumulators[half] = accumulate_sse2(accumulators[half], bytes + idx * kStripeSize + half * 16, kSecret.words + offset + half * 2, idx);
+                    if (offset == kStripesPerBlock - 1)
+                        accumulators[half] = scramble_sse2(accumulators[half], kScrambleSecret + half * 2);
+                }
+            }
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 0), accumulators[0]);
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 2), accumulators[1]);
+        #else
+            for (std::size_t idx = 0; idx < stripe_count; ++idx)
+            {
+                const std::size_t offset = idx % kStripesPerBlock;
+                accumulate_scalar(lanes, bytes + idx * kStripeSize, kSecret.words + offset, idx);
+                if (offset == kStripesPerBlock - 1)
+                    scramble_scalar(lanes);
+            }
+        #endif
+    }
+
+    {// Remaining bytes, zero-padded into a last stripe
+        const std::size_t remainder = size - stripe_count * kStripeSize;
+        if (remainder > 0)
+        {
+            std::byte stripe[kStripeSize] = {};
+            std::memcpy(stripe, bytes + stripe_count * kStripeSize, remainder);
+            accumulate_scalar(lanes, stripe, kSecret.words + stripe_count % kStripesPerBlock, stripe_count);
+        }
+    }
+
+    return finalize(lanes, size);
+}
+
+#undef BLK_HASH_SSE2
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdio>
+
+#include <string>
+#include <string_view>
+
+// Quoted JSON string, e.g. names written into reports and traces
+//  NOTE Bytes are copied as is, i.e. the text is expected to be UTF-8
+inline std::string json_string(std::string_view text)
+{
+    std::string escaped;
+    escaped.reserve(text.size() + 2);
+    escaped.push_back('"');
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':  escaped += "\\\""; break;
+        case '\\': escaped += "\\\\"; break;
+        case '\b': escaped += "\\b";  break;
+        case '\f': escaped += "\\f";  break;
+        case '\n': escaped += "\\n";  break;
+        case '\r': escaped += "\\r";  break;
+        case '\t': escaped += "\\t";  break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char control[7];
+                std::snprintf(control, sizeof(control), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+                escaped += control;
+            }
+            else
+            {
+                escaped.push_back(c);
+            }
+            break;
+        }
+    }
+    escaped.push_back('"');
+    return escaped;
+}